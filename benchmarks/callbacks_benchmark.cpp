@@ -0,0 +1,63 @@
+/**
+ * @file callbacks_benchmark.cpp
+ * @brief Cost of triggering and replacing a callbacks::Event callback.
+ *
+ * The trigger benchmarks measure one Event::trigger() through its std::function, once with a
+ * callback set and once without (the null check only). The set-and-trigger benchmark also
+ * replaces the callback before each trigger, which copies the std::function; with a capture
+ * too large for the small-buffer optimization, that copy allocates.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+#include "callbacks/callbacks.hpp"
+
+using namespace callbacks;
+
+namespace {
+
+void BM_EventTrigger(benchmark::State &state) {
+    Event event;
+    std::int64_t calls = 0;
+    event.setCallback([&calls]() { ++calls; });
+    for (auto _ : state) {
+        event.trigger();
+    }
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_EventTriggerUnset(benchmark::State &state) {
+    Event event;
+    for (auto _ : state) {
+        event.trigger();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_EventSetAndTrigger(benchmark::State &state) {
+    Event event;
+    std::int64_t calls = 0;
+    std::array<std::int64_t, 4> captured{1, 2, 3, 4}; // 32 bytes: beyond the small buffer.
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            event.setCallback([&calls]() { ++calls; });
+        } else {
+            event.setCallback([&calls, captured]() { calls += captured[0]; });
+        }
+        event.trigger();
+    }
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_EventTrigger);
+BENCHMARK(BM_EventTriggerUnset);
+BENCHMARK(BM_EventSetAndTrigger)->ArgName("largeCapture")->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+/**
+ * @file event_journal_benchmark.cpp
+ * @brief Append and replay throughput of the memory-mapped EventJournal.
+ *
+ * The append benchmark journals small typed events with each SyncMode and a group commit
+ * every 1024 records, to show that appending costs a copy rather than a system call and how
+ * much the periodic msync() adds. The replay benchmarks read back a journal of one million
+ * events, once through the raw JournalReader (reported in bytes/second, to compare with
+ * memory bandwidth) and once into a TypedEventQueue.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+#include "event_queue/event_journal.hpp"
+
+using namespace event_queue;
+
+namespace {
+
+struct Trade {
+    std::uint64_t instrument;
+    std::int64_t price;
+    std::int64_t quantity;
+};
+
+using Journal = TypedEventJournal<Trade>;
+
+constexpr int kReplayEvents = 1000000;
+
+std::filesystem::path benchmarkDirectory(const char *name) {
+    return std::filesystem::temp_directory_path() /
+           ("event_journal_benchmark_" + std::to_string(::getpid()) + "_" + name);
+}
+
+void BM_JournalAppend(benchmark::State &state) {
+    const auto directory = benchmarkDirectory("append");
+    std::filesystem::remove_all(directory);
+    {
+        EventJournal::Options options;
+        options.syncMode = static_cast<EventJournal::SyncMode>(state.range(0));
+        Journal journal(directory, options);
+        std::int64_t i = 0;
+        for (auto _ : state) {
+            journal.append(Trade{7, 100 + i, i});
+            ++i;
+        }
+    }
+    std::filesystem::remove_all(directory);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Writes the journal read by the replay benchmarks (once per process).
+ */
+const std::filesystem::path &replayDirectory() {
+    static const std::filesystem::path directory = []() {
+        const auto path = benchmarkDirectory("replay");
+        std::filesystem::remove_all(path);
+        EventJournal::Options options;
+        options.syncMode = EventJournal::SyncMode::None;
+        Journal journal(path, options);
+        for (int i = 0; i < kReplayEvents; ++i) {
+            journal.append(Trade{7, 100 + i, i});
+        }
+        return path;
+    }();
+    return directory;
+}
+
+void BM_JournalReplayRaw(benchmark::State &state) {
+    const auto &directory = replayDirectory();
+    std::int64_t bytes = 0;
+    for (auto _ : state) {
+        JournalReader reader(directory, state.range(0) != 0);
+        std::uint64_t sum = 0;
+        reader.forEach([&](const JournalReader::Record &record) {
+            sum += record.payload.size();
+        });
+        benchmark::DoNotOptimize(sum);
+        bytes += static_cast<std::int64_t>(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kReplayEvents);
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_JournalReplayIntoQueue(benchmark::State &state) {
+    const auto &directory = replayDirectory();
+    Journal::Queue queue;
+    queue.reserve(kReplayEvents);
+    for (auto _ : state) {
+        Journal::replay(directory, queue);
+        state.PauseTiming();
+        queue.processEvents([](const auto &) {});
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kReplayEvents);
+}
+
+} // namespace
+
+BENCHMARK(BM_JournalAppend)
+    ->ArgName("syncMode")
+    ->Arg(static_cast<int>(EventJournal::SyncMode::None))
+    ->Arg(static_cast<int>(EventJournal::SyncMode::Async))
+    ->Arg(static_cast<int>(EventJournal::SyncMode::Sync));
+BENCHMARK(BM_JournalReplayRaw)->ArgName("verify")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_JournalReplayIntoQueue)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::filesystem::remove_all(benchmarkDirectory("replay"));
+    return 0;
+}
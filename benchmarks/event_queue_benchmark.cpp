@@ -0,0 +1,271 @@
+/**
+ * @file event_queue_benchmark.cpp
+ * @brief Push throughput benchmarks for the EventQueue backends.
+ *
+ * Each benchmark runs 1..N producer threads that push small events into a shared queue while
+ * a dedicated consumer thread drains it. The same workload is measured against the
+ * mutex-protected backend, the lock-free ring buffer backend and the sharded backend (where
+ * every producer thread registers its own SPSC ring), so the reported items/second show how
+ * push throughput scales with the number of producers.
+ *
+ * The priority benchmark keeps a bulk lane saturated and measures how long a probe event waits
+ * between push and dispatch, once in the same lane as the bulk traffic and once in the High
+ * lane.
+ *
+ * The push/process benchmark pushes one event and processes it on the same thread, which is
+ * the per-event latency of each backend without contention.
+ *
+ * The wake-up benchmark measures the round trip between two threads that park in
+ * EventQueue::waitAndProcess() and wake each other with a single push.
+ *
+ * The timer benchmark schedules and cancels a timer while N other timers are outstanding, to
+ * show that both operations stay O(1) up to a million pending timers.
+ *
+ * The payload benchmarks push batches of events that each carry a copy of a 64..4096 byte
+ * buffer and drain them, once with the copy held in a std::vector (one heap allocation per
+ * event) and once with pushPayloadEvent(), which carves it from the queue's arena.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "event_queue/event_queue.hpp"
+
+using namespace event_queue;
+
+namespace {
+
+/**
+ * @brief Shared state for one multi-threaded benchmark run.
+ *
+ * Thread 0 creates the queue and the consumer before the timed loop starts and tears them down
+ * after every producer has left the loop (Google Benchmark synchronizes threads at both points).
+ */
+struct PushFixture {
+    std::unique_ptr<EventQueue> queue;
+    std::thread consumer;
+    std::atomic<bool> stop{false};
+    std::atomic<long> sink{0};
+
+    void start(EventQueue::Backend backend) {
+        queue = std::make_unique<EventQueue>(backend);
+        stop.store(false);
+        consumer = std::thread([this]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                queue->processEvents();
+            }
+            queue->processEvents();
+        });
+    }
+
+    void finish() {
+        stop.store(true);
+        consumer.join();
+        queue.reset();
+    }
+};
+
+PushFixture fixture;
+
+void pushThroughput(benchmark::State &state, EventQueue::Backend backend) {
+    if (state.thread_index() == 0) {
+        fixture.start(backend);
+    }
+    for (auto _ : state) {
+        fixture.queue->pushEvent([]() {
+            fixture.sink.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    if (state.thread_index() == 0) {
+        fixture.finish();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PushMutex(benchmark::State &state) {
+    pushThroughput(state, EventQueue::Backend::Mutex);
+}
+
+void BM_PushLockFreeRing(benchmark::State &state) {
+    pushThroughput(state, EventQueue::Backend::LockFreeRing);
+}
+
+void BM_PushShardedSpsc(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        fixture.start(EventQueue::Backend::ShardedSpsc);
+    }
+    std::optional<EventQueue::Producer> producer;
+    for (auto _ : state) {
+        // Register on the first iteration, once thread 0 is known to have created the queue.
+        if (!producer) {
+            producer.emplace(fixture.queue->registerProducer());
+        }
+        producer->push([]() {
+            fixture.sink.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    if (state.thread_index() == 0) {
+        fixture.finish();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PushProcess(benchmark::State &state) {
+    EventQueue queue(static_cast<EventQueue::Backend>(state.range(0)));
+    long sink = 0;
+    for (auto _ : state) {
+        queue.pushEvent([&sink]() { ++sink; });
+        queue.processEvents();
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_WakeupRoundTrip(benchmark::State &state) {
+    EventQueue ping;
+    EventQueue pong;
+    bool running = true;
+    // The echo thread answers every ping by pushing onto the pong queue.
+    std::thread echo([&]() {
+        while (running) {
+            ping.waitAndProcess();
+        }
+    });
+    for (auto _ : state) {
+        bool answered = false;
+        ping.pushEvent([&]() { pong.pushEvent([&answered]() { answered = true; }); });
+        while (!answered) {
+            pong.waitAndProcess();
+        }
+    }
+    ping.pushEvent([&running]() { running = false; });
+    echo.join();
+    // Each iteration is two wake-ups.
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+void BM_ProbeLatencyUnderLoad(benchmark::State &state) {
+    const auto probePriority = static_cast<EventQueue::Priority>(state.range(0));
+    EventQueue queue;
+    std::atomic<bool> stop{false};
+    std::atomic<long> outstanding{0};
+    std::thread consumer([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            queue.processEvents();
+        }
+    });
+    // Keep roughly 100k bulk events queued in the Normal lane at all times.
+    std::thread flooder([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (outstanding.load(std::memory_order_relaxed) >= 100000) {
+                std::this_thread::yield();
+                continue;
+            }
+            outstanding.fetch_add(1, std::memory_order_relaxed);
+            queue.pushEvent([&outstanding]() { outstanding.fetch_sub(1, std::memory_order_relaxed); });
+        }
+    });
+    for (auto _ : state) {
+        std::atomic<bool> ran{false};
+        const auto pushed = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point dispatched;
+        queue.pushEvent(
+            [&]() {
+                dispatched = std::chrono::steady_clock::now();
+                ran.store(true, std::memory_order_release);
+            },
+            probePriority);
+        while (!ran.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        state.SetIterationTime(std::chrono::duration<double>(dispatched - pushed).count());
+    }
+    stop.store(true);
+    flooder.join();
+    consumer.join();
+}
+
+/**
+ * @brief Schedules and cancels one timer while state.range(0) other timers are pending.
+ */
+void BM_TimerScheduleCancel(benchmark::State &state) {
+    EventQueue queue;
+    const auto outstanding = static_cast<std::size_t>(state.range(0));
+    for (std::size_t i = 0; i < outstanding; ++i) {
+        queue.scheduleAfter(std::chrono::seconds(60) + std::chrono::microseconds(i), []() {});
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto id = queue.scheduleAfter(std::chrono::milliseconds(1 + (i++ % 100000)), []() {});
+        benchmark::DoNotOptimize(queue.cancelTimer(id));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Events pushed per drained batch in the payload benchmarks.
+constexpr int kPayloadBatch = 256;
+
+/**
+ * @brief Pushes and drains events carrying a heap-allocated copy of a state.range(0)-byte payload.
+ */
+void BM_PayloadHeap(benchmark::State &state) {
+    EventQueue queue;
+    const std::vector<std::byte> payload(static_cast<std::size_t>(state.range(0)), std::byte{1});
+    std::size_t sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < kPayloadBatch; ++i) {
+            queue.pushEvent([&sum, copy = std::vector<std::byte>(payload)]() { sum += copy.size(); });
+        }
+        queue.processEvents();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * kPayloadBatch);
+}
+
+/**
+ * @brief Pushes and drains events carrying an arena copy of a state.range(0)-byte payload.
+ */
+void BM_PayloadArena(benchmark::State &state) {
+    EventQueue queue;
+    const std::vector<std::byte> payload(static_cast<std::size_t>(state.range(0)), std::byte{1});
+    std::size_t sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < kPayloadBatch; ++i) {
+            queue.pushPayloadEvent(payload, [&sum](std::span<const std::byte> data) { sum += data.size(); });
+        }
+        queue.processEvents();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * kPayloadBatch);
+    state.counters["chunks"] = static_cast<double>(queue.payloadStats().chunks);
+}
+
+} // namespace
+
+BENCHMARK(BM_PayloadHeap)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_PayloadArena)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_TimerScheduleCancel)->RangeMultiplier(100)->Range(1, 1000000);
+BENCHMARK(BM_ProbeLatencyUnderLoad)
+    ->ArgName("priority")
+    ->Arg(static_cast<int>(EventQueue::Priority::Normal))
+    ->Arg(static_cast<int>(EventQueue::Priority::High))
+    ->UseManualTime();
+BENCHMARK(BM_PushMutex)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_PushLockFreeRing)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_PushShardedSpsc)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_PushProcess)
+    ->ArgName("backend")
+    ->Arg(static_cast<int>(EventQueue::Backend::Mutex))
+    ->Arg(static_cast<int>(EventQueue::Backend::LockFreeRing))
+    ->Arg(static_cast<int>(EventQueue::Backend::ShardedSpsc));
+BENCHMARK(BM_WakeupRoundTrip)->UseRealTime();
+
+BENCHMARK_MAIN();
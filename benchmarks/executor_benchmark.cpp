@@ -0,0 +1,121 @@
+/**
+ * @file executor_benchmark.cpp
+ * @brief Scaling benchmark for the work-stealing Executor.
+ *
+ * Each iteration submits a fixed batch of CPU-bound events and waits for all of them to finish.
+ * The benchmark is repeated for 1..N workers (N being the number of hardware threads), so the
+ * items/second column shows how close throughput comes to linear scaling. For comparison, the
+ * same batch is also run through a single EventQueue drained by one thread.
+ *
+ * The strand benchmark spreads the same batch over state.range(0) strands, to show what
+ * per-key ordering costs compared with unordered submits, and the strand lifecycle benchmark
+ * measures creating a strand, posting one event to it and dropping the handle.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include "event_queue/event_queue.hpp"
+#include "event_queue/executor.hpp"
+#include "event_queue/strand.hpp"
+
+using namespace event_queue;
+
+namespace {
+
+constexpr int kEventsPerBatch = 1024;
+
+/**
+ * @brief A CPU-bound handler of a few microseconds that the compiler cannot optimize away.
+ */
+void burnCpu(std::uint64_t seed) {
+    std::uint64_t x = seed;
+    for (int i = 0; i < 2000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    benchmark::DoNotOptimize(x);
+}
+
+void BM_ExecutorScaling(benchmark::State &state) {
+    Executor executor(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::latch done(kEventsPerBatch);
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            executor.submit([&done, i]() {
+                burnCpu(static_cast<std::uint64_t>(i) + 1);
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+void BM_SingleQueueBaseline(benchmark::State &state) {
+    EventQueue queue;
+    for (auto _ : state) {
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            queue.pushEvent([i]() { burnCpu(static_cast<std::uint64_t>(i) + 1); });
+        }
+        queue.processEvents();
+    }
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+void BM_StrandFanOut(benchmark::State &state) {
+    Executor executor;
+    std::vector<Strand> strands;
+    for (std::int64_t s = 0; s < state.range(0); ++s) {
+        strands.emplace_back(executor);
+    }
+    for (auto _ : state) {
+        std::latch done(kEventsPerBatch);
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            strands[static_cast<std::size_t>(i) % strands.size()].post([&done, i]() {
+                burnCpu(static_cast<std::uint64_t>(i) + 1);
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+void BM_StrandLifecycle(benchmark::State &state) {
+    Executor executor;
+    for (auto _ : state) {
+        std::latch done(kEventsPerBatch);
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            Strand strand(executor);
+            strand.post([&done]() { done.count_down(); });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+/**
+ * @brief Registers worker counts 1, 2, 4, ... up to the number of hardware threads.
+ */
+void workerCounts(benchmark::internal::Benchmark *bench) {
+    const auto maxWorkers = static_cast<std::int64_t>(Executor::defaultWorkerCount());
+    for (std::int64_t workers = 1; workers < maxWorkers; workers *= 2) {
+        bench->Arg(workers);
+    }
+    bench->Arg(maxWorkers);
+}
+
+} // namespace
+
+BENCHMARK(BM_SingleQueueBaseline)->UseRealTime();
+BENCHMARK(BM_ExecutorScaling)->Apply(workerCounts)->UseRealTime();
+BENCHMARK(BM_StrandFanOut)->RangeMultiplier(8)->Range(1, 1024)->UseRealTime();
+BENCHMARK(BM_StrandLifecycle)->UseRealTime();
+
+BENCHMARK_MAIN();
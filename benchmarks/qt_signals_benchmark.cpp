@@ -0,0 +1,70 @@
+/**
+ * @file qt_signals_benchmark.cpp
+ * @brief Cost of emitting QtSignalsExample::mySignal over direct and queued connections.
+ *
+ * With a direct connection, emitting calls the receiver immediately, so the time per item is
+ * the signal dispatch overhead. With a queued connection, every emission copies its arguments
+ * into an event posted to the receiver's thread; the benchmark emits a batch and then
+ * delivers it with QCoreApplication::sendPostedEvents(), so the time per item covers both
+ * posting and delivery.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QObject>
+#include <QString>
+
+#include <cstdint>
+
+#include "qt_signals/qt_signals.hpp"
+
+using namespace qt_signals;
+
+namespace {
+
+void emitSignals(benchmark::State &state, Qt::ConnectionType type) {
+    const std::int64_t batch = state.range(0);
+    QtSignalsExample sender;
+    QObject receiver;
+    std::int64_t received = 0;
+    QObject::connect(&sender, &QtSignalsExample::mySignal, &receiver,
+                     [&received](const QString &message) { received += message.size(); }, type);
+    const QString message = QStringLiteral("price update");
+    for (auto _ : state) {
+        for (std::int64_t i = 0; i < batch; ++i) {
+            sender.emitSignal(message);
+        }
+        if (type == Qt::QueuedConnection) {
+            QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        }
+    }
+    benchmark::DoNotOptimize(received);
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+void BM_QtDirectEmit(benchmark::State &state) {
+    emitSignals(state, Qt::DirectConnection);
+}
+
+void BM_QtQueuedEmit(benchmark::State &state) {
+    emitSignals(state, Qt::QueuedConnection);
+}
+
+} // namespace
+
+BENCHMARK(BM_QtDirectEmit)->ArgName("batch")->Arg(1)->Arg(64);
+BENCHMARK(BM_QtQueuedEmit)->ArgName("batch")->Arg(1)->Arg(64);
+
+int main(int argc, char **argv) {
+    // Queued connections need an application object to post events to.
+    QCoreApplication app(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
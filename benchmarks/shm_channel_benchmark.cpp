@@ -0,0 +1,105 @@
+/**
+ * @file shm_channel_benchmark.cpp
+ * @brief Cross-process throughput and round-trip latency of ShmChannel.
+ *
+ * Every benchmark forks a child process that attaches to the channels by name. The throughput
+ * benchmark streams records of several sizes to a draining child. The round-trip benchmark
+ * bounces one record off an echoing child, once with both sides spinning (the latency floor,
+ * which needs two free cores) and once with a spin count of zero, so that every message
+ * crosses a futex wake-up.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "event_queue/shm_channel.hpp"
+
+using namespace event_queue;
+
+namespace {
+
+std::string channelName(const char *suffix) {
+    return "/shm_channel_benchmark_" + std::to_string(::getpid()) + "_" + suffix;
+}
+
+/**
+ * @brief Runs @p body in a child process and returns its pid.
+ */
+template <typename F>
+pid_t spawn(F &&body) {
+    const pid_t child = ::fork();
+    if (child == 0) {
+        body();
+        ::_exit(0);
+    }
+    return child;
+}
+
+void BM_ShmChannelThroughput(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const std::string name = channelName("stream");
+    ShmChannel::Options options;
+    options.capacity = std::size_t{4} << 20;
+    ShmChannel channel(name, ShmChannel::OpenMode::Create, options);
+    const pid_t child = spawn([&name]() {
+        ShmChannel consumer(name, ShmChannel::OpenMode::Open);
+        std::size_t bytes = 0;
+        while (consumer.waitAndProcess([&bytes](const ShmChannel::Message &message) {
+            bytes += message.payload.size();
+        })) {
+        }
+        benchmark::DoNotOptimize(bytes);
+    });
+
+    const std::vector<std::byte> payload(size, std::byte{42});
+    for (auto _ : state) {
+        while (!channel.pushEvent(1, payload)) {
+        }
+    }
+    channel.close();
+    ::waitpid(child, nullptr, 0);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+void BM_ShmChannelRoundTrip(benchmark::State &state) {
+    const std::string pingName = channelName("ping");
+    const std::string pongName = channelName("pong");
+    ShmChannel::Options options;
+    options.capacity = 64 * 1024;
+    options.spinCount = static_cast<std::size_t>(state.range(0));
+    ShmChannel ping(pingName, ShmChannel::OpenMode::Create, options);
+    ShmChannel pong(pongName, ShmChannel::OpenMode::Create, options);
+    const pid_t child = spawn([&]() {
+        ShmChannel in(pingName, ShmChannel::OpenMode::Open, options);
+        ShmChannel out(pongName, ShmChannel::OpenMode::Open, options);
+        while (in.waitAndProcess([&out](const ShmChannel::Message &message) {
+            out.pushEvent(message.type, message.payload);
+        })) {
+        }
+    });
+
+    std::uint64_t sequence = 0;
+    for (auto _ : state) {
+        ping.pushEvent(1, sequence++);
+        pong.waitFor(std::chrono::nanoseconds::max());
+        pong.processEvents([](const ShmChannel::Message &) {});
+    }
+    ping.close();
+    ::waitpid(child, nullptr, 0);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ShmChannelThroughput)->Arg(16)->Arg(64)->Arg(512)->UseRealTime();
+BENCHMARK(BM_ShmChannelRoundTrip)->ArgName("spinCount")->Arg(1 << 14)->Arg(0)->UseRealTime();
+
+BENCHMARK_MAIN();
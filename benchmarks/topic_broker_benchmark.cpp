@@ -0,0 +1,183 @@
+/**
+ * @file topic_broker_benchmark.cpp
+ * @brief Publish cost of TopicBroker as topics, subscriptions and topic depth grow.
+ *
+ * Each run registers one exact subscription per topic ("orders.<region>.<n>") and a few
+ * wildcard subscriptions ("orders.<region>.*", "orders.#", "*.eu.*"), then publishes:
+ * - the same topic over and over (a hot topic, served by the match cache),
+ * - random cached topics while an unrelated pattern is subscribed and unsubscribed between
+ *   publishes, which must not invalidate their cache entries,
+ * - a different topic every time with the cache disabled (every publish walks the trie),
+ * - the same random topics through a linear scan of all patterns, the design a Subject per
+ *   topic with wildcard matching amounts to.
+ * A last benchmark varies the depth of the topics at a fixed subscription count.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "observer/topic_broker.hpp"
+
+using namespace observer;
+
+namespace {
+
+constexpr std::size_t kRegions = 8;
+const char *const kRegionNames[kRegions] = {"eu", "us", "apac", "latam", "mea", "uk", "ch", "jp"};
+
+class CountingObserver : public BasicObserver<int> {
+public:
+    void onNotify(const int &event) override { total += static_cast<std::size_t>(event); }
+
+    std::size_t total = 0;
+};
+
+std::string topicName(std::size_t index) {
+    return std::string("orders.") + kRegionNames[index % kRegions] + "." + std::to_string(index);
+}
+
+/**
+ * @brief A broker with @p topics exact subscriptions plus a few wildcard ones.
+ */
+struct Fixture {
+    explicit Fixture(std::size_t topics, std::size_t cacheCapacity) : broker(makeOptions(cacheCapacity)) {
+        for (std::size_t i = 0; i < topics; ++i) {
+            patterns.push_back(topicName(i));
+        }
+        for (const char *region : kRegionNames) {
+            patterns.push_back(std::string("orders.") + region + ".*");
+        }
+        patterns.push_back("orders.#");
+        patterns.push_back("*.eu.*");
+        for (const std::string &pattern : patterns) {
+            subscriptions.push_back(broker.subscribe(pattern, &observer));
+        }
+        std::mt19937 random(1);
+        for (int i = 0; i < 4096; ++i) {
+            published.push_back(topicName(random() % topics));
+        }
+    }
+
+    static BasicTopicBroker<int>::Options makeOptions(std::size_t cacheCapacity) {
+        BasicTopicBroker<int>::Options options;
+        options.cacheCapacity = cacheCapacity;
+        return options;
+    }
+
+    CountingObserver observer;
+    BasicTopicBroker<int> broker;
+    std::vector<std::string> patterns;
+    std::vector<Subscription> subscriptions;
+    std::vector<std::string> published; ///< Random existing topics.
+};
+
+void BM_BrokerPublishHot(benchmark::State &state) {
+    Fixture fixture(static_cast<std::size_t>(state.range(0)), 4096);
+    const std::string &topic = fixture.published.front();
+    std::size_t delivered = 0;
+    for (auto _ : state) {
+        delivered += fixture.broker.publish(topic, 1);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+}
+
+void BM_BrokerPublishUncached(benchmark::State &state) {
+    Fixture fixture(static_cast<std::size_t>(state.range(0)), 0);
+    std::size_t i = 0;
+    std::size_t delivered = 0;
+    for (auto _ : state) {
+        delivered += fixture.broker.publish(fixture.published[i++ % fixture.published.size()], 1);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+}
+
+void BM_BrokerPublishUnderChurn(benchmark::State &state) {
+    Fixture fixture(static_cast<std::size_t>(state.range(0)), 4096);
+    CountingObserver transient;
+    // Keeps the churned pattern's trie nodes alive, so the loop measures the cache, not allocation.
+    Subscription anchor = fixture.broker.subscribe("trades.eu.*", &transient);
+    std::size_t i = 0;
+    std::size_t delivered = 0;
+    for (auto _ : state) {
+        Subscription churn = fixture.broker.subscribe("trades.eu.*", &transient);
+        delivered += fixture.broker.publish(fixture.published[i++ % 1024], 1);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+}
+
+/**
+ * @brief Matches a dotted pattern against a dotted topic, level by level.
+ */
+bool matches(std::string_view pattern, std::string_view topic) {
+    while (true) {
+        const std::size_t patternDot = pattern.find('.');
+        const std::string_view level = pattern.substr(0, patternDot);
+        if (level == "#") {
+            return true;
+        }
+        const std::size_t topicDot = topic.find('.');
+        if (level != "*" && level != topic.substr(0, topicDot)) {
+            return false;
+        }
+        if (patternDot == std::string_view::npos || topicDot == std::string_view::npos) {
+            return patternDot == topicDot ||
+                   (topicDot == std::string_view::npos && pattern.substr(patternDot + 1) == "#");
+        }
+        pattern.remove_prefix(patternDot + 1);
+        topic.remove_prefix(topicDot + 1);
+    }
+}
+
+void BM_LinearPublish(benchmark::State &state) {
+    Fixture fixture(static_cast<std::size_t>(state.range(0)), 0);
+    std::size_t i = 0;
+    std::size_t delivered = 0;
+    for (auto _ : state) {
+        const std::string &topic = fixture.published[i++ % fixture.published.size()];
+        for (const std::string &pattern : fixture.patterns) {
+            if (matches(pattern, topic)) {
+                fixture.observer.onNotify(1);
+                ++delivered;
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+}
+
+void BM_BrokerPublishDepth(benchmark::State &state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    BasicTopicBroker<int> broker(Fixture::makeOptions(0));
+    CountingObserver observer;
+    std::vector<Subscription> subscriptions;
+    std::vector<std::string> topics;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        std::string topic = "t" + std::to_string(i % 100);
+        for (std::size_t level = 1; level < depth; ++level) {
+            topic += "." + std::to_string((i + level) % 10);
+        }
+        subscriptions.push_back(broker.subscribe(topic, &observer));
+        topics.push_back(std::move(topic));
+    }
+    subscriptions.push_back(broker.subscribe("#", &observer));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(broker.publish(topics[i++ % topics.size()], 1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_BrokerPublishHot)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_BrokerPublishUnderChurn)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_BrokerPublishUncached)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_LinearPublish)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_BrokerPublishDepth)->DenseRange(1, 8, 1);
+
+BENCHMARK_MAIN();
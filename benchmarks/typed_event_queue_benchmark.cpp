@@ -0,0 +1,147 @@
+/**
+ * @file typed_event_queue_benchmark.cpp
+ * @brief Dispatch throughput of TypedEventQueue compared with type-erased event queues.
+ *
+ * Every iteration pushes a batch of small events of three kinds and then drains it on the same
+ * thread, with handlers that fold the event payloads into a running total. The same workload
+ * is run through:
+ * - a mutex-protected std::vector of std::function<void()> (the original EventQueue design),
+ * - EventQueue, whose events are SmallFunction callables drained in batch mode,
+ * - TypedEventQueue, whose events are a std::variant of plain structs dispatched with std::visit.
+ *
+ * The items/second column therefore shows what type erasure costs per event.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "event_queue/event_queue.hpp"
+#include "event_queue/typed_event_queue.hpp"
+
+using namespace event_queue;
+
+namespace {
+
+constexpr int kEventsPerBatch = 4096;
+
+struct KeyPressed {
+    int key;
+};
+
+struct MouseMoved {
+    int dx;
+    int dy;
+};
+
+struct Tick {
+    std::uint64_t frame;
+};
+
+/**
+ * @brief Accumulates the events' payloads so that the handlers cannot be optimized away.
+ */
+struct Totals {
+    std::uint64_t keys = 0;
+    std::int64_t motion = 0;
+    std::uint64_t frames = 0;
+
+    void onKey(const KeyPressed &event) { keys += static_cast<std::uint64_t>(event.key); }
+    void onMouse(const MouseMoved &event) { motion += event.dx - event.dy; }
+    void onTick(const Tick &event) { frames ^= event.frame; }
+};
+
+void BM_StdFunctionQueue(benchmark::State &state) {
+    std::mutex mutex;
+    std::vector<std::function<void()>> pending;
+    std::vector<std::function<void()>> batch;
+    Totals totals;
+    for (auto _ : state) {
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            std::lock_guard<std::mutex> lock(mutex);
+            switch (i % 3) {
+            case 0:
+                pending.emplace_back([&totals, i]() { totals.onKey(KeyPressed{i}); });
+                break;
+            case 1:
+                pending.emplace_back([&totals, i]() { totals.onMouse(MouseMoved{i, i / 2}); });
+                break;
+            default:
+                pending.emplace_back([&totals, i]() { totals.onTick(Tick{static_cast<std::uint64_t>(i)}); });
+                break;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(pending);
+        }
+        for (auto &event : batch) {
+            event();
+        }
+        batch.clear();
+    }
+    benchmark::DoNotOptimize(totals);
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+void BM_TypeErasedEventQueue(benchmark::State &state) {
+    EventQueue queue;
+    Totals totals;
+    for (auto _ : state) {
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            switch (i % 3) {
+            case 0:
+                queue.pushEvent([&totals, i]() { totals.onKey(KeyPressed{i}); });
+                break;
+            case 1:
+                queue.pushEvent([&totals, i]() { totals.onMouse(MouseMoved{i, i / 2}); });
+                break;
+            default:
+                queue.pushEvent([&totals, i]() { totals.onTick(Tick{static_cast<std::uint64_t>(i)}); });
+                break;
+            }
+        }
+        queue.processEvents(EventQueue::DrainMode::Batch);
+    }
+    benchmark::DoNotOptimize(totals);
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+void BM_TypedEventQueue(benchmark::State &state) {
+    TypedEventQueue<KeyPressed, MouseMoved, Tick> queue;
+    Totals totals;
+    const auto visitor = Overloaded{
+        [&totals](const KeyPressed &event) { totals.onKey(event); },
+        [&totals](const MouseMoved &event) { totals.onMouse(event); },
+        [&totals](const Tick &event) { totals.onTick(event); },
+    };
+    for (auto _ : state) {
+        for (int i = 0; i < kEventsPerBatch; ++i) {
+            switch (i % 3) {
+            case 0:
+                queue.pushEvent(KeyPressed{i});
+                break;
+            case 1:
+                queue.pushEvent(MouseMoved{i, i / 2});
+                break;
+            default:
+                queue.pushEvent(Tick{static_cast<std::uint64_t>(i)});
+                break;
+            }
+        }
+        queue.processEvents(visitor);
+    }
+    benchmark::DoNotOptimize(totals);
+    state.SetItemsProcessed(state.iterations() * kEventsPerBatch);
+}
+
+} // namespace
+
+BENCHMARK(BM_StdFunctionQueue);
+BENCHMARK(BM_TypeErasedEventQueue);
+BENCHMARK(BM_TypedEventQueue);
+
+BENCHMARK_MAIN();
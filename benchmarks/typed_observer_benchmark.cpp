@@ -0,0 +1,129 @@
+/**
+ * @file typed_observer_benchmark.cpp
+ * @brief Cost of string messages compared with structured events in observer subjects.
+ *
+ * Every iteration publishes one price update to 10 observers that fold the price into a
+ * running total. The same workload is run through:
+ * - Subject, whose producer formats the update into a std::string that every observer parses
+ *   back,
+ * - BasicSubject<PriceUpdate>, which passes a plain struct by reference,
+ * - BasicSubject<std::variant<...>>, which passes a variant of structs by reference.
+ *
+ * The allocs/notify counter counts calls to the global operator new per publish.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "observer/observer.hpp"
+#include "observer/subject.hpp"
+
+#include "allocation_counter.hpp"
+
+using namespace observer;
+
+namespace {
+
+constexpr int kObservers = 10;
+
+struct PriceUpdate {
+    int instrument;
+    double price;
+};
+
+struct TradeHalted {
+    int instrument;
+};
+
+using MarketEvent = std::variant<PriceUpdate, TradeHalted>;
+
+class StringObserver : public IObserver {
+public:
+    void onNotify(const std::string &message) override {
+        const char *price = std::strstr(message.c_str(), "price=");
+        total += price ? std::strtod(price + 6, nullptr) : 0.0;
+    }
+
+    double total = 0.0;
+};
+
+class PriceObserver : public BasicObserver<PriceUpdate> {
+public:
+    void onNotify(const PriceUpdate &event) override { total += event.price; }
+
+    double total = 0.0;
+};
+
+class MarketObserver : public BasicObserver<MarketEvent> {
+public:
+    void onNotify(const MarketEvent &event) override {
+        if (const auto *update = std::get_if<PriceUpdate>(&event)) {
+            total += update->price;
+        }
+    }
+
+    double total = 0.0;
+};
+
+/**
+ * @brief Registers kObservers observers of type @p ObserverType, runs @p publish per iteration
+ *        and reports the allocations per publish.
+ */
+template <typename ObserverType, typename SubjectType, typename Publish>
+void run(benchmark::State &state, SubjectType &subject, Publish publish) {
+    std::vector<std::unique_ptr<ObserverType>> observers;
+    std::vector<Subscription> subscriptions;
+    for (int i = 0; i < kObservers; ++i) {
+        observers.push_back(std::make_unique<ObserverType>());
+        subscriptions.push_back(subject.addObserver(observers.back().get()));
+    }
+    const std::size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    int sequence = 0;
+    for (auto _ : state) {
+        publish(sequence++);
+    }
+    const std::size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    benchmark::DoNotOptimize(observers.front()->total);
+    state.counters["allocs/notify"] =
+        benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * kObservers);
+}
+
+void BM_StringMessageNotify(benchmark::State &state) {
+    Subject subject;
+    run<StringObserver>(state, subject, [&subject](int sequence) {
+        subject.notify("instrument=" + std::to_string(sequence % 64) +
+                       " price=" + std::to_string(100.0 + sequence % 100));
+    });
+}
+
+void BM_StructEventNotify(benchmark::State &state) {
+    BasicSubject<PriceUpdate> subject;
+    run<PriceObserver>(state, subject, [&subject](int sequence) {
+        subject.notify(PriceUpdate{sequence % 64, 100.0 + sequence % 100});
+    });
+}
+
+void BM_VariantEventNotify(benchmark::State &state) {
+    BasicSubject<MarketEvent> subject;
+    run<MarketObserver>(state, subject, [&subject](int sequence) {
+        subject.notify(MarketEvent{PriceUpdate{sequence % 64, 100.0 + sequence % 100}});
+    });
+}
+
+} // namespace
+
+BENCHMARK(BM_StringMessageNotify);
+BENCHMARK(BM_StructEventNotify);
+BENCHMARK(BM_VariantEventNotify);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,46 @@
+# cmake/run_benchmark.cmake
+#
+# This script runs one benchmark executable and writes its results as Google
+# Benchmark JSON, tagged with the project version, the build type and the git
+# revision of the source tree. The revision is read when the script runs, not
+# when the build tree is configured, so results of later commits are never
+# tagged with a stale revision.
+#
+# Usage (the benchmark_json target in benchmarks/CMakeLists.txt does this for
+# every benchmark):
+#
+#       cmake -DBENCHMARK=<executable> -DOUTPUT=<file.json>
+#             -DSOURCE_DIR=<source dir> -DGIT_EXECUTABLE=<git>
+#             -DPROJECT_VERSION=<version> -DBUILD_TYPE=<build type>
+#             -DBENCHMARK_ARGS=<extra arguments>
+#             -P cmake/run_benchmark.cmake
+
+set(_revision "unknown")
+if(GIT_EXECUTABLE)
+    execute_process(
+        COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE _revision_out
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE _revision_result
+        ERROR_QUIET
+    )
+    if(_revision_result EQUAL 0)
+        set(_revision ${_revision_out})
+    endif()
+endif()
+
+separate_arguments(_args NATIVE_COMMAND "${BENCHMARK_ARGS}")
+execute_process(
+    COMMAND ${BENCHMARK}
+        --benchmark_out=${OUTPUT}
+        --benchmark_out_format=json
+        --benchmark_context=project_version=${PROJECT_VERSION}
+        --benchmark_context=git_revision=${_revision}
+        --benchmark_context=build_type=${BUILD_TYPE}
+        ${_args}
+    RESULT_VARIABLE _result
+)
+if(NOT _result EQUAL 0)
+    message(FATAL_ERROR "${BENCHMARK} failed: ${_result}")
+endif()
@@ -0,0 +1,184 @@
+#ifndef CIRCULAR_BUFFER_HPP
+#define CIRCULAR_BUFFER_HPP
+
+/**
+ * @file circular_buffer.hpp
+ * @brief Declaration of CircularBuffer, a growable FIFO backed by one contiguous allocation.
+ *
+ * std::queue over std::deque allocates and frees a node every few elements as the queue
+ * advances, even when its length stays constant. CircularBuffer keeps its elements in a single
+ * power-of-two array that wraps around, so once it has grown to the working-set size, pushing
+ * and popping never touch the allocator again.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace event_queue {
+
+/**
+ * @brief A FIFO container with a std::queue-like interface and a reusable ring of storage.
+ *
+ * Elements live in a power-of-two array addressed by a head index and a size. The array only
+ * grows (doubling) when it is full; its capacity is kept across pops and clear(). The class is
+ * not thread-safe.
+ *
+ * @tparam T The element type. It must be nothrow move-constructible.
+ */
+template <typename T>
+class CircularBuffer {
+public:
+    /**
+     * @brief Constructs an empty buffer without allocating.
+     */
+    CircularBuffer() noexcept = default;
+
+    CircularBuffer(const CircularBuffer &) = delete;
+    CircularBuffer &operator=(const CircularBuffer &) = delete;
+
+    /**
+     * @brief Move constructor. Leaves @p other empty and without storage.
+     */
+    CircularBuffer(CircularBuffer &&other) noexcept { swap(other); }
+
+    /**
+     * @brief Move assignment. Leaves @p other empty and without storage.
+     */
+    CircularBuffer &operator=(CircularBuffer &&other) noexcept {
+        if (this != &other) {
+            CircularBuffer(std::move(other)).swap(*this);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destroys all elements and releases the storage.
+     */
+    ~CircularBuffer() {
+        clear();
+        std::allocator<T>().deallocate(data_, capacity_);
+    }
+
+    /**
+     * @brief Appends an element constructed from @p args.
+     *
+     * @return A reference to the new element.
+     */
+    template <typename... Args>
+    T &emplace(Args &&...args) {
+        if (size_ == capacity_) {
+            grow(capacity_ == 0 ? kInitialCapacity : capacity_ * 2);
+        }
+        T *slot = data_ + ((head_ + size_) & (capacity_ - 1));
+        ::new (static_cast<void *>(slot)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    /**
+     * @brief Appends @p value.
+     */
+    void push(T &&value) { emplace(std::move(value)); }
+
+    /**
+     * @brief Returns the oldest element. The buffer must not be empty.
+     */
+    T &front() { return data_[head_]; }
+
+    /**
+     * @brief Removes the oldest element. The buffer must not be empty.
+     */
+    void pop() {
+        data_[head_].~T();
+        head_ = (head_ + 1) & (capacity_ - 1);
+        --size_;
+    }
+
+    /**
+     * @brief Returns the element at logical position @p index (0 is the oldest).
+     */
+    T &operator[](std::size_t index) { return data_[(head_ + index) & (capacity_ - 1)]; }
+
+    /**
+     * @brief Checks whether the buffer holds no elements.
+     */
+    bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief Returns the number of stored elements.
+     */
+    std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Returns the number of elements that fit without reallocating.
+     */
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Returns the bytes of the storage array (e.g. to place it with bindToNumaNode()).
+     */
+    std::span<const std::byte> storage() const noexcept {
+        return std::as_bytes(std::span<const T>(data_, capacity_));
+    }
+
+    /**
+     * @brief Ensures room for at least @p count elements (rounded up to a power of two).
+     */
+    void reserve(std::size_t count) {
+        std::size_t target = capacity_ == 0 ? kInitialCapacity : capacity_;
+        while (target < count) {
+            target *= 2;
+        }
+        if (target != capacity_) {
+            grow(target);
+        }
+    }
+
+    /**
+     * @brief Destroys all elements while keeping the storage for reuse.
+     */
+    void clear() noexcept {
+        while (size_ != 0) {
+            pop();
+        }
+        head_ = 0;
+    }
+
+    /**
+     * @brief Exchanges contents and storage with @p other in O(1).
+     */
+    void swap(CircularBuffer &other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    static constexpr std::size_t kInitialCapacity = 16; ///< First allocation size (power of two).
+
+    void grow(std::size_t newCapacity) {
+        T *newData = std::allocator<T>().allocate(newCapacity);
+        for (std::size_t i = 0; i < size_; ++i) {
+            T &old = (*this)[i];
+            ::new (static_cast<void *>(newData + i)) T(std::move(old));
+            old.~T();
+        }
+        std::allocator<T>().deallocate(data_, capacity_);
+        data_ = newData;
+        capacity_ = newCapacity;
+        head_ = 0;
+    }
+
+    T *data_ = nullptr;         ///< Element storage (capacity_ slots).
+    std::size_t capacity_ = 0;  ///< Number of slots; zero or a power of two.
+    std::size_t head_ = 0;      ///< Slot index of the oldest element.
+    std::size_t size_ = 0;      ///< Number of live elements.
+};
+
+} // namespace event_queue
+
+#endif // CIRCULAR_BUFFER_HPP
@@ -0,0 +1,217 @@
+#ifndef COROUTINE_HPP
+#define COROUTINE_HPP
+
+/**
+ * @file coroutine.hpp
+ * @brief Declaration of Task, a lazy C++20 coroutine type for code running on an EventQueue.
+ *
+ * Together with EventQueue::schedule(), Task lets a multi-stage handler be written as straight-line
+ * code instead of nested lambdas:
+ *
+ * @code
+ * Task<int> parse(EventQueue &queue, std::string text) {
+ *     co_await queue.schedule();          // Continue on the queue's consumer thread.
+ *     co_return static_cast<int>(text.size());
+ * }
+ *
+ * Task<> pipeline(EventQueue &queue) {
+ *     const int length = co_await parse(queue, "hello");
+ *     ...
+ * }
+ * @endcode
+ *
+ * A Task does not run until it is awaited or start()ed. When it finishes, it resumes its
+ * awaiter directly through symmetric transfer, so long chains of awaits use constant stack.
+ */
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace event_queue {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Promise state shared by every Task specialization.
+ */
+class TaskPromiseBase {
+public:
+    /**
+     * @brief Resumes the awaiting coroutine (if any) when the task finishes.
+     */
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            const std::coroutine_handle<> continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    void setContinuation(std::coroutine_handle<> continuation) noexcept { continuation_ = continuation; }
+
+    void rethrowIfFailed() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::coroutine_handle<> continuation_; ///< The coroutine awaiting this task, if any.
+    std::exception_ptr exception_;         ///< The exception that escaped the task, if any.
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+        requires std::is_convertible_v<U, T>
+    void return_value(U &&value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T takeResult() {
+        rethrowIfFailed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_; ///< The value passed to co_return.
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void takeResult() const { rethrowIfFailed(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief A lazily started coroutine producing a value of type @p T.
+ *
+ * A Task owns its coroutine frame and destroys it when the Task is destroyed. It is move-only.
+ * Awaiting a Task starts it and yields its result (or rethrows the exception that escaped it).
+ * A top-level Task that nobody awaits is started with start() and must be kept alive until
+ * done() returns true.
+ *
+ * @tparam T The type of the value produced by co_return, or void.
+ */
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+
+    Task(Task &&other) noexcept
+        : handle_(std::exchange(other.handle_, {})), started_(std::exchange(other.started_, false)) {}
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, {});
+            started_ = std::exchange(other.started_, false);
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { reset(); }
+
+    /**
+     * @brief Runs the coroutine until its first suspension point (or to completion).
+     *
+     * Has no effect if the task has already been started.
+     */
+    void start() {
+        if (handle_ && !started_) {
+            started_ = true;
+            handle_.resume();
+        }
+    }
+
+    /**
+     * @brief Checks whether the coroutine has run to completion.
+     */
+    bool done() const noexcept { return handle_ && handle_.done(); }
+
+    /**
+     * @brief Returns the result of a completed task, rethrowing any exception that escaped it.
+     *
+     * Must only be called once, after done() returned true.
+     */
+    T result() { return handle_.promise().takeResult(); }
+
+    /**
+     * @brief Awaiting a task starts it and resumes the awaiter once it completes.
+     */
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().setContinuation(awaiting);
+                return handle; // Symmetric transfer: start the task without growing the stack.
+            }
+
+            T await_resume() { return handle.promise().takeResult(); }
+        };
+        started_ = true;
+        return Awaiter{handle_};
+    }
+
+private:
+    void reset() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = {};
+        }
+    }
+
+    Handle handle_;        ///< The owned coroutine frame.
+    bool started_ = false; ///< Whether the coroutine has been resumed for the first time.
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+} // namespace event_queue
+
+#endif // COROUTINE_HPP
@@ -0,0 +1,386 @@
+/**
+ * @file event_journal.cpp
+ * @brief Implementation of EventJournal and JournalReader.
+ *
+ * Segment files are created at their full size with ftruncate() (sparse on most file systems)
+ * and mapped shared, so appends are plain stores into the page cache. A record's length field
+ * is stored last with release ordering: a record cut short by a crash reads as the end of its
+ * segment, and the checksum catches pages that were only partly written back before a power
+ * loss.
+ */
+
+#include "event_journal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace event_queue {
+
+namespace {
+
+constexpr char kMagic[8] = {'E', 'V', 'J', 'R', 'N', 'L', '0', '1'};
+constexpr std::size_t kSegmentHeaderSize = 16;
+constexpr std::size_t kRecordHeaderSize = 16;
+constexpr std::size_t kRecordAlignment = 8;
+constexpr const char *kSegmentExtension = ".journal";
+
+/**
+ * @brief The fixed header in front of every record.
+ */
+struct RecordHeader {
+    std::uint32_t length;   ///< Total record length (header, payload, padding); 0 marks the end.
+    std::uint32_t type;     ///< Caller-defined record type.
+    std::uint32_t size;     ///< Payload size in bytes.
+    std::uint32_t checksum; ///< checksum() of type, size and payload.
+};
+static_assert(sizeof(RecordHeader) == kRecordHeaderSize);
+
+constexpr std::size_t alignRecord(std::size_t value) {
+    return (value + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+/**
+ * @brief A fast 64-bit multiply-xor hash over 8-byte words, folded to 32 bits.
+ */
+std::uint32_t checksum(std::uint32_t type, std::span<const std::byte> payload) {
+    constexpr std::uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+    std::uint64_t hash = (std::uint64_t{type} << 32 | payload.size()) * kMultiplier;
+    std::size_t i = 0;
+    for (; i + 8 <= payload.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, payload.data() + i, 8);
+        hash = (hash ^ word) * kMultiplier;
+        hash ^= hash >> 29;
+    }
+    if (i < payload.size()) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, payload.data() + i, payload.size() - i);
+        hash = (hash ^ word) * kMultiplier;
+        hash ^= hash >> 29;
+    }
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+std::uint32_t readLength(const std::byte *record) {
+    std::uint32_t length;
+    std::memcpy(&length, record, sizeof(length));
+    return length;
+}
+
+/**
+ * @brief Returns the length of the valid record at @p offset, or 0 if the segment ends there.
+ */
+std::size_t validRecord(const std::byte *base, std::size_t size, std::size_t offset, bool verify) {
+    if (offset + kRecordHeaderSize > size) {
+        return 0;
+    }
+    RecordHeader header;
+    std::memcpy(&header, base + offset, sizeof(header));
+    if (header.length < kRecordHeaderSize || header.length > size - offset ||
+        header.length != alignRecord(kRecordHeaderSize + header.size)) {
+        return 0;
+    }
+    if (verify &&
+        checksum(header.type, std::span<const std::byte>(base + offset + kRecordHeaderSize, header.size)) !=
+            header.checksum) {
+        return 0;
+    }
+    return header.length;
+}
+
+std::filesystem::path segmentPath(const std::filesystem::path &directory, std::uint64_t index) {
+    char name[32];
+    const auto result = std::to_chars(name, name + 20, index);
+    std::string digits(name, result.ptr);
+    digits.insert(0, digits.size() < 8 ? 8 - digits.size() : 0, '0');
+    return directory / (digits + kSegmentExtension);
+}
+
+/**
+ * @brief Returns the indices of the segment files in @p directory, in ascending order.
+ */
+std::vector<std::uint64_t> listSegments(const std::filesystem::path &directory) {
+    std::vector<std::uint64_t> indices;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+        const std::filesystem::path &path = entry.path();
+        if (path.extension() != kSegmentExtension) {
+            continue;
+        }
+        const std::string stem = path.stem().string();
+        std::uint64_t index = 0;
+        const auto result = std::from_chars(stem.data(), stem.data() + stem.size(), index);
+        if (result.ec == std::errc() && result.ptr == stem.data() + stem.size()) {
+            indices.push_back(index);
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+[[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+EventJournal::EventJournal(const std::filesystem::path &directory) : EventJournal(directory, Options{}) {
+}
+
+EventJournal::EventJournal(const std::filesystem::path &directory, const Options &options)
+    : directory_(directory), options_(options) {
+    if (options_.segmentSize < kSegmentHeaderSize + kRecordHeaderSize + kRecordAlignment) {
+        throw std::invalid_argument("EventJournal: segment size too small");
+    }
+    std::filesystem::create_directories(directory_);
+    const std::vector<std::uint64_t> segments = listSegments(directory_);
+    if (segments.empty()) {
+        openSegment(1, true);
+        return;
+    }
+    // Continue after the last intact record of the newest segment, unless it was written with
+    // another segment size.
+    std::error_code error;
+    if (std::filesystem::file_size(segmentPath(directory_, segments.back()), error) != options_.segmentSize) {
+        openSegment(segments.back() + 1, true);
+        return;
+    }
+    openSegment(segments.back(), false);
+    std::size_t offset = kSegmentHeaderSize;
+    while (const std::size_t length = validRecord(base_, options_.segmentSize, offset, true)) {
+        offset += length;
+    }
+    if (offset + kRecordHeaderSize <= options_.segmentSize && readLength(base_ + offset) != 0) {
+        // The segment ends in a damaged record: leave it as is and start a fresh one.
+        closeSegment();
+        openSegment(segments.back() + 1, true);
+        return;
+    }
+    offset_ = offset;
+    committedOffset_ = offset;
+}
+
+EventJournal::~EventJournal() {
+    try {
+        commit();
+    } catch (const std::system_error &) {
+        // Nothing to report to from a destructor; the records stay in the page cache.
+    }
+    closeSegment();
+}
+
+void EventJournal::append(std::uint32_t type, std::span<const std::byte> payload) {
+    const std::size_t length = alignRecord(kRecordHeaderSize + payload.size());
+    if (length > options_.segmentSize - kSegmentHeaderSize) {
+        throw std::length_error("EventJournal: record larger than a segment");
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool commitDue = false;
+    if (offset_ + length > options_.segmentSize) {
+        // The rest of the segment stays zero, which readers take as its end. Its written range
+        // keeps the mapping alive until a commit has flushed it.
+        if (offset_ != committedOffset_) {
+            unflushed_.push_back(FlushRange{mapping_, committedOffset_, offset_});
+        }
+        const std::uint64_t next = segmentIndex_ + 1;
+        closeSegment();
+        openSegment(next, true);
+        commitDue = true;
+    }
+    std::byte *record = base_ + offset_;
+    RecordHeader header{0, type, static_cast<std::uint32_t>(payload.size()), checksum(type, payload)};
+    std::memcpy(record, &header, sizeof(header));
+    if (!payload.empty()) {
+        std::memcpy(record + kRecordHeaderSize, payload.data(), payload.size());
+    }
+    // Publish the record by storing its length last.
+    std::atomic_ref<std::uint32_t>(*reinterpret_cast<std::uint32_t *>(record))
+        .store(static_cast<std::uint32_t>(length), std::memory_order_release);
+    offset_ += length;
+    ++appended_;
+    ++uncommittedRecords_;
+    uncommittedBytes_ += length;
+    commitDue = commitDue ||
+                (options_.commitEveryRecords != 0 && uncommittedRecords_ >= options_.commitEveryRecords) ||
+                (options_.commitEveryBytes != 0 && uncommittedBytes_ >= options_.commitEveryBytes);
+    lock.unlock();
+    if (commitDue) {
+        // Leave the records to the commit already flushing, if any; the counters still show
+        // them, so a later append triggers again.
+        std::unique_lock<std::mutex> commitLock(commitMutex_, std::try_to_lock);
+        if (commitLock.owns_lock()) {
+            flush(takeUnflushed());
+        }
+    }
+}
+
+void EventJournal::commit() {
+    std::lock_guard<std::mutex> commitLock(commitMutex_);
+    flush(takeUnflushed());
+}
+
+std::vector<EventJournal::FlushRange> EventJournal::takeUnflushed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uncommittedRecords_ = 0;
+    uncommittedBytes_ = 0;
+    std::vector<FlushRange> ranges;
+    ranges.swap(unflushed_);
+    if (base_ != nullptr && offset_ != committedOffset_) {
+        ranges.push_back(FlushRange{mapping_, committedOffset_, offset_});
+        committedOffset_ = offset_;
+    }
+    return ranges;
+}
+
+void EventJournal::flush(const std::vector<FlushRange> &ranges) const {
+    if (options_.syncMode == SyncMode::None) {
+        return;
+    }
+    // msync() needs a page-aligned start; flush from the page holding the first new byte.
+    const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const int flags = options_.syncMode == SyncMode::Sync ? MS_SYNC : MS_ASYNC;
+    for (const FlushRange &range : ranges) {
+        const std::size_t start = range.start & ~(pageSize - 1);
+        if (::msync(range.mapping.get() + start, range.end - start, flags) != 0) {
+            throwErrno("EventJournal: msync");
+        }
+    }
+}
+
+void EventJournal::clear() {
+    std::lock_guard<std::mutex> commitLock(commitMutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    unflushed_.clear();
+    closeSegment();
+    for (const std::uint64_t index : listSegments(directory_)) {
+        std::filesystem::remove(segmentPath(directory_, index));
+    }
+    openSegment(1, true);
+    uncommittedRecords_ = 0;
+    uncommittedBytes_ = 0;
+}
+
+std::uint64_t EventJournal::appendedRecords() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appended_;
+}
+
+void EventJournal::openSegment(std::uint64_t index, bool create) {
+    const std::filesystem::path path = segmentPath(directory_, index);
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throwErrno("EventJournal: open");
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(options_.segmentSize)) != 0) {
+        const int error = errno;
+        ::close(fd_);
+        fd_ = -1;
+        throw std::system_error(error, std::generic_category(), "EventJournal: ftruncate");
+    }
+    void *mapping = ::mmap(nullptr, options_.segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd_);
+        fd_ = -1;
+        throw std::system_error(error, std::generic_category(), "EventJournal: mmap");
+    }
+    base_ = static_cast<std::byte *>(mapping);
+    mapping_ = std::shared_ptr<std::byte>(base_, [size = options_.segmentSize](std::byte *base) {
+        ::munmap(base, size);
+    });
+    segmentIndex_ = index;
+    if (create) {
+        std::memcpy(base_, kMagic, sizeof(kMagic));
+        std::memcpy(base_ + sizeof(kMagic), &index, sizeof(index));
+    }
+    offset_ = kSegmentHeaderSize;
+    committedOffset_ = create ? 0 : kSegmentHeaderSize; // A new header still has to be flushed.
+}
+
+void EventJournal::closeSegment() {
+    // The mapping itself goes away with the last range still waiting to be flushed.
+    mapping_.reset();
+    base_ = nullptr;
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+JournalReader::JournalReader(const std::filesystem::path &directory, bool verify) : verify_(verify) {
+    for (const std::uint64_t index : listSegments(directory)) {
+        segments_.push_back(segmentPath(directory, index));
+    }
+}
+
+JournalReader::~JournalReader() {
+    closeSegment();
+}
+
+bool JournalReader::next(Record &record) {
+    while (true) {
+        if (base_ != nullptr) {
+            if (const std::size_t length = validRecord(base_, size_, offset_, verify_)) {
+                RecordHeader header;
+                std::memcpy(&header, base_ + offset_, sizeof(header));
+                record.type = header.type;
+                record.payload = std::span<const std::byte>(base_ + offset_ + kRecordHeaderSize, header.size);
+                offset_ += length;
+                return true;
+            }
+        }
+        if (!openNextSegment()) {
+            return false;
+        }
+    }
+}
+
+bool JournalReader::openNextSegment() {
+    closeSegment();
+    while (nextSegment_ < segments_.size()) {
+        const std::filesystem::path &path = segments_[nextSegment_++];
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throwErrno("JournalReader: open");
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kSegmentHeaderSize) {
+            ::close(fd);
+            continue; // Not a complete segment.
+        }
+        const auto size = static_cast<std::size_t>(info.st_size);
+        void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // The mapping keeps the file referenced.
+        if (mapping == MAP_FAILED) {
+            throwErrno("JournalReader: mmap");
+        }
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+        base_ = static_cast<const std::byte *>(mapping);
+        size_ = size;
+        if (std::memcmp(base_, kMagic, sizeof(kMagic)) != 0) {
+            closeSegment();
+            continue; // Not a journal segment.
+        }
+        offset_ = kSegmentHeaderSize;
+        return true;
+    }
+    return false;
+}
+
+void JournalReader::closeSegment() {
+    if (base_ != nullptr) {
+        ::munmap(const_cast<std::byte *>(base_), size_);
+        base_ = nullptr;
+    }
+}
+
+} // namespace event_queue
@@ -0,0 +1,348 @@
+#ifndef EVENT_JOURNAL_HPP
+#define EVENT_JOURNAL_HPP
+
+/**
+ * @file event_journal.hpp
+ * @brief Declaration of EventJournal, a memory-mapped append-only log of typed events.
+ *
+ * Events held in an EventQueue are lost if the process dies. For events that are plain data,
+ * EventJournal records each one in a segmented log before it is dispatched, and JournalReader
+ * feeds the log back on restart.
+ *
+ * Each segment is a fixed-size file mapped into memory. Appending copies the record into the
+ * mapping under a short lock, so there is no system call per event. Durability is batched:
+ * commit() (called automatically every Options::commitEveryRecords records or
+ * Options::commitEveryBytes bytes) flushes the dirty pages with one msync(), after releasing the
+ * append lock, so a slow flush does not hold up other appending threads. Reading maps the
+ * segments read-only and walks them sequentially without copying.
+ *
+ * The journal is POSIX-only (it relies on mmap()).
+ *
+ * On disk, a segment is a 16-byte header (magic and index) followed by 8-byte-aligned records:
+ * @code
+ * uint32 length    total record length including this header; written last, 0 = end
+ * uint32 type      caller-defined record type
+ * uint32 size      payload size in bytes
+ * uint32 checksum  hash of type, size and payload
+ * payload[size], zero padding to a multiple of 8
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "typed_event_queue.hpp"
+
+namespace event_queue {
+
+/**
+ * @brief An append-only, memory-mapped, segmented record log.
+ *
+ * append() may be called from any number of threads. A segment is full when the next record
+ * does not fit; the journal then starts the next one, which is the only time an append makes
+ * system calls under the append lock, and the full segment is flushed by the next commit. The
+ * append that reaches a commit threshold runs the commit itself once it has released the lock;
+ * if another commit is already flushing, it leaves the records to the next one instead of
+ * waiting. Reopening a directory continues after the last intact record, in a new segment if
+ * the last one ended in a damaged record.
+ */
+class EventJournal {
+public:
+    /**
+     * @brief Selects how commit() makes appended records durable.
+     */
+    enum class SyncMode {
+        /// Leave flushing to the operating system. Records survive a process crash (they are
+        /// in the page cache) but not a power loss.
+        None,
+        /// Schedule the write-back with msync(MS_ASYNC) and return immediately.
+        Async,
+        /// Wait for the write-back with msync(MS_SYNC).
+        Sync
+    };
+
+    /**
+     * @brief Construction-time configuration of an EventJournal.
+     */
+    struct Options {
+        /// Size of each segment file. Records must fit in a segment.
+        std::size_t segmentSize = std::size_t{64} << 20;
+        /// Commit after this many appended records; zero disables the record trigger.
+        std::size_t commitEveryRecords = 1024;
+        /// Commit after this many appended bytes; zero disables the byte trigger.
+        std::size_t commitEveryBytes = std::size_t{1} << 20;
+        /// How commit() flushes the records.
+        SyncMode syncMode = SyncMode::Sync;
+    };
+
+    /**
+     * @brief Opens (or creates) the journal in @p directory with the default options.
+     */
+    explicit EventJournal(const std::filesystem::path &directory);
+
+    /**
+     * @brief Opens (or creates) the journal in @p directory and continues after its last record.
+     *
+     * @throws std::system_error if the directory or a segment cannot be created or mapped.
+     * @throws std::invalid_argument if Options::segmentSize is too small to hold a record.
+     */
+    EventJournal(const std::filesystem::path &directory, const Options &options);
+
+    EventJournal(const EventJournal &) = delete;
+    EventJournal &operator=(const EventJournal &) = delete;
+
+    /**
+     * @brief Commits the pending records and unmaps the current segment.
+     */
+    ~EventJournal();
+
+    /**
+     * @brief Appends one record.
+     *
+     * @param type A caller-defined tag returned with the record on replay.
+     * @param payload The record bytes.
+     * @throws std::length_error if the record cannot fit in a segment.
+     */
+    void append(std::uint32_t type, std::span<const std::byte> payload);
+
+    /**
+     * @brief Appends a trivially copyable value as a record of @p type.
+     */
+    template <typename T>
+        requires(std::is_trivially_copyable_v<T> && !std::is_convertible_v<const T &, std::span<const std::byte>>)
+    void append(std::uint32_t type, const T &value) {
+        append(type, std::span<const std::byte>(reinterpret_cast<const std::byte *>(&value), sizeof(T)));
+    }
+
+    /**
+     * @brief Makes every record appended so far durable according to Options::syncMode.
+     *
+     * Waits for a commit running on another thread to finish first.
+     */
+    void commit();
+
+    /**
+     * @brief Deletes every segment and starts an empty journal (e.g. after a checkpoint).
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of records appended through this object.
+     */
+    std::uint64_t appendedRecords() const;
+
+    /**
+     * @brief Returns the directory holding the segments.
+     */
+    const std::filesystem::path &directory() const { return directory_; }
+
+private:
+    /**
+     * @brief A range of a segment that has been written but not flushed yet.
+     */
+    struct FlushRange {
+        std::shared_ptr<std::byte> mapping; ///< Keeps the segment mapped until the range is flushed.
+        std::size_t start;                  ///< First unflushed byte.
+        std::size_t end;                    ///< End of the written bytes.
+    };
+
+    void openSegment(std::uint64_t index, bool create);
+    void closeSegment();
+    std::vector<FlushRange> takeUnflushed();
+    void flush(const std::vector<FlushRange> &ranges) const;
+
+    std::filesystem::path directory_;   ///< Where the segment files live.
+    Options options_;                   ///< The configuration given at construction.
+    std::mutex commitMutex_;            ///< Serializes commits; held during msync(). Taken before mutex_.
+    mutable std::mutex mutex_;          ///< Serializes appends and segment changes; never held during msync().
+    int fd_ = -1;                       ///< The current segment's file descriptor.
+    std::shared_ptr<std::byte> mapping_; ///< The current segment's mapping; unmapped with its last owner.
+    std::byte *base_ = nullptr;         ///< mapping_.get(), for appends.
+    std::vector<FlushRange> unflushed_; ///< Written ranges of earlier segments, for the next commit.
+    std::uint64_t segmentIndex_ = 0;    ///< Index of the current segment.
+    std::size_t offset_ = 0;            ///< Where the next record goes in the current segment.
+    std::size_t committedOffset_ = 0;   ///< End of the last committed range of the current segment.
+    std::size_t uncommittedRecords_ = 0; ///< Records appended since the last commit.
+    std::size_t uncommittedBytes_ = 0;  ///< Bytes appended since the last commit.
+    std::uint64_t appended_ = 0;        ///< Records appended through this object.
+};
+
+/**
+ * @brief Reads the records of a journal directory in append order.
+ *
+ * Segments are mapped read-only one at a time and records are returned as views into the
+ * mapping, so reading costs little more than touching the bytes. A segment ends at its first
+ * empty or damaged record (a torn write after a crash); reading then continues with the next
+ * segment. The journal must not be written while it is read.
+ */
+class JournalReader {
+public:
+    /**
+     * @brief One record. The payload stays valid until the reader moves past its segment.
+     */
+    struct Record {
+        std::uint32_t type = 0;
+        std::span<const std::byte> payload;
+    };
+
+    /**
+     * @brief Lists the segments of @p directory. A missing directory reads as empty.
+     *
+     * @param directory The journal directory.
+     * @param verify Whether to check each record's checksum.
+     */
+    explicit JournalReader(const std::filesystem::path &directory, bool verify = true);
+
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+
+    ~JournalReader();
+
+    /**
+     * @brief Advances to the next record.
+     *
+     * @param record Receives the record on success.
+     * @return true if a record was read, false at the end of the journal.
+     * @throws std::system_error if a segment cannot be mapped.
+     */
+    bool next(Record &record);
+
+    /**
+     * @brief Calls @p visitor with every remaining record.
+     *
+     * @return The number of records visited.
+     */
+    template <typename F>
+    std::size_t forEach(F &&visitor) {
+        std::size_t count = 0;
+        Record record;
+        while (next(record)) {
+            visitor(record);
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    bool openNextSegment();
+    void closeSegment();
+
+    std::vector<std::filesystem::path> segments_; ///< Segment files in index order.
+    std::size_t nextSegment_ = 0;                 ///< Index into segments_ of the next file to map.
+    bool verify_;                                 ///< Whether checksums are checked.
+    const std::byte *base_ = nullptr;             ///< The current segment's mapping.
+    std::size_t size_ = 0;                        ///< Size of the current mapping.
+    std::size_t offset_ = 0;                      ///< Offset of the next record.
+};
+
+/**
+ * @brief Journals the events of a TypedEventQueue so that they can be replayed after a crash.
+ *
+ * Each event type is stored as its index in @p Events, so the list must only ever be extended
+ * at the end. Events must be trivially copyable: they are stored as their object bytes.
+ *
+ * @code
+ * TypedEventJournal<Deposit, Withdrawal> journal("journal");
+ * TypedEventJournal<Deposit, Withdrawal>::replay("journal", queue); // On startup.
+ * journal.push(queue, Deposit{42, 100});                            // Journal, then enqueue.
+ * @endcode
+ *
+ * @tparam Events The event types, as in the TypedEventQueue.
+ */
+template <typename... Events>
+class TypedEventJournal {
+    static_assert((std::is_trivially_copyable_v<Events> && ...),
+                  "TypedEventJournal: events must be trivially copyable");
+
+public:
+    using Queue = TypedEventQueue<Events...>;
+
+    /**
+     * @brief Opens (or creates) the journal in @p directory; see EventJournal::EventJournal().
+     */
+    explicit TypedEventJournal(const std::filesystem::path &directory) : journal_(directory) {}
+
+    /**
+     * @brief Opens (or creates) the journal in @p directory with the given options.
+     */
+    TypedEventJournal(const std::filesystem::path &directory, const EventJournal::Options &options)
+        : journal_(directory, options) {}
+
+    /**
+     * @brief Appends @p event to the journal.
+     */
+    template <typename E>
+        requires Queue::template holds<E>
+    void append(const E &event) {
+        journal_.append(typeIndex<std::decay_t<E>>(), event);
+    }
+
+    /**
+     * @brief Appends @p event to the journal and then pushes it onto @p queue.
+     */
+    template <typename E>
+        requires Queue::template holds<E>
+    void push(Queue &queue, E &&event) {
+        append(event);
+        queue.pushEvent(std::forward<E>(event));
+    }
+
+    /**
+     * @brief Pushes every event journaled in @p directory onto @p queue, in append order.
+     *
+     * @return The number of events replayed.
+     * @throws std::runtime_error if a record has an unknown type or the wrong size.
+     */
+    static std::size_t replay(const std::filesystem::path &directory, Queue &queue) {
+        JournalReader reader(directory);
+        return reader.forEach([&queue](const JournalReader::Record &record) {
+            if (record.type >= sizeof...(Events)) {
+                throw std::runtime_error("TypedEventJournal: unknown event type in journal");
+            }
+            kDecoders[record.type](record.payload, queue);
+        });
+    }
+
+    /**
+     * @brief Returns the underlying journal (for commit() or clear()).
+     */
+    EventJournal &journal() { return journal_; }
+
+private:
+    using Decoder = void (*)(std::span<const std::byte>, Queue &);
+
+    template <typename E>
+    static constexpr std::uint32_t typeIndex() {
+        std::uint32_t index = 0;
+        const bool found = ((std::is_same_v<E, Events> ? true : (++index, false)) || ...);
+        return found ? index : UINT32_MAX;
+    }
+
+    template <typename E>
+    static void decode(std::span<const std::byte> payload, Queue &queue) {
+        if (payload.size() != sizeof(E)) {
+            throw std::runtime_error("TypedEventJournal: event size does not match its type");
+        }
+        alignas(E) std::byte storage[sizeof(E)];
+        std::memcpy(storage, payload.data(), sizeof(E));
+        queue.pushEvent(*std::launder(reinterpret_cast<E *>(storage)));
+    }
+
+    static constexpr Decoder kDecoders[] = {&decode<Events>...};
+
+    EventJournal journal_; ///< The record log.
+};
+
+} // namespace event_queue
+
+#endif // EVENT_JOURNAL_HPP
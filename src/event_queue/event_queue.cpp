@@ -4,47 +4,758 @@
  *
  * This file implements the methods declared in event_queue.hpp. The EventQueue
  * class provides a thread-safe FIFO queue for storing and processing events,
- * where each event is represented as a callable object (std::function<void()>).
+ * where each event is represented as a move-only callable object (SmallFunction<void()>).
  * The implementation ensures that events can be pushed and processed safely across
- * multiple threads.
+ * multiple threads. Depending on the selected backend, each priority lane is stored either
+ * in a mutex-protected CircularBuffer or in a lock-free MpscRingBuffer. Delayed and periodic
+ * events live in a TimingWheel guarded by its own mutex.
  */
 
 #include "event_queue.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace event_queue {
 
-void EventQueue::pushEvent(const Event &event) {
-    // Lock the mutex to ensure exclusive access to the queue.
-    std::lock_guard<std::mutex> lock(mutex_);
-    events_.push(event);
+namespace {
+
+/**
+ * @brief Runs an event if it holds a callable.
+ */
+void runEvent(EventQueue::Event &event) {
+    if (event) {
+        event();
+    }
 }
 
-void EventQueue::processEvents() {
-    while (true) {
+} // namespace
+
+/**
+ * @brief Limits how many events a drain may run and until when.
+ *
+ * The clock is read only before every Options::deadlineCheckInterval-th event, so that for
+ * tiny events the deadline check does not cost more than the events themselves.
+ */
+class EventQueue::ProcessLimit {
+public:
+    /**
+     * @brief A limit that never stops the drain.
+     */
+    ProcessLimit() = default;
+
+    ProcessLimit(std::size_t maxEvents, std::chrono::steady_clock::time_point deadline,
+                 std::size_t checkInterval)
+        : maxEvents_(maxEvents), deadline_(deadline), checkInterval_(std::max<std::size_t>(checkInterval, 1)) {}
+
+    /**
+     * @brief Checks whether one more event may run.
+     */
+    bool allows() {
+        if (processed_ >= maxEvents_ || expired_) {
+            return false;
+        }
+        if (deadline_ != std::chrono::steady_clock::time_point::max() && processed_ % checkInterval_ == 0 &&
+            processed_ != checkedAt_) {
+            checkedAt_ = processed_;
+            expired_ = std::chrono::steady_clock::now() >= deadline_;
+        }
+        return !expired_;
+    }
+
+    /**
+     * @brief Records that an event has run.
+     */
+    void consume() { ++processed_; }
+
+    std::size_t processed() const { return processed_; }
+
+private:
+    std::size_t maxEvents_ = SIZE_MAX;
+    std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+    std::size_t checkInterval_ = 1;
+    std::size_t processed_ = 0;
+    std::size_t checkedAt_ = SIZE_MAX; ///< Value of processed_ at the last clock read.
+    bool expired_ = false;
+};
+
+/**
+ * @brief The queued placeholder of a coalesced event.
+ *
+ * The event itself lives in coalesced_ so that later pushes with the same key can replace it;
+ * the placeholder runs whichever event is stored when its turn comes. If it is destroyed
+ * without running (dropped by a bounded queue, or the queue is destroyed), it removes the key.
+ */
+class EventQueue::CoalescedDispatch {
+public:
+    CoalescedDispatch(EventQueue &queue, std::uint64_t key) : queue_(&queue), key_(key) {}
+
+    CoalescedDispatch(CoalescedDispatch &&other) noexcept
+        : queue_(std::exchange(other.queue_, nullptr)), key_(other.key_) {}
+
+    CoalescedDispatch(const CoalescedDispatch &) = delete;
+    CoalescedDispatch &operator=(const CoalescedDispatch &) = delete;
+    CoalescedDispatch &operator=(CoalescedDispatch &&) = delete;
+
+    ~CoalescedDispatch() {
+        if (queue_ != nullptr) {
+            std::lock_guard<std::mutex> lock(queue_->coalesceMutex_);
+            queue_->coalesced_.erase(key_);
+        }
+    }
+
+    void operator()() {
         Event event;
+        {
+            std::lock_guard<std::mutex> lock(queue_->coalesceMutex_);
+            auto it = queue_->coalesced_.find(key_);
+            event = std::move(it->second);
+            // From here on, a push with the same key enqueues a new dispatch.
+            queue_->coalesced_.erase(it);
+        }
+        queue_ = nullptr;
+        runEvent(event);
+    }
+
+private:
+    EventQueue *queue_; ///< The owning queue, or nullptr once run or moved from.
+    std::uint64_t key_; ///< The coalescing key.
+};
+
+EventQueue::LaneScheduler::LaneScheduler(DispatchPolicy policy,
+                                         const std::array<unsigned, kPriorityCount> &weights)
+    : policy_(policy), weights_(weights) {
+    for (auto &weight : weights_) {
+        weight = std::max(weight, 1u);
+    }
+    credit_ = weights_[0];
+}
+
+std::size_t EventQueue::LaneScheduler::next(const std::array<bool, kPriorityCount> &ready) {
+    if (policy_ == DispatchPolicy::Strict) {
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            if (ready[lane]) {
+                return lane;
+            }
+        }
+        return kPriorityCount;
+    }
+    // Weighted round-robin: stay on the current lane while it has credit and events, then
+    // move on to the next lane with a fresh credit. Two full turns visit every lane.
+    for (std::size_t step = 0; step <= 2 * kPriorityCount; ++step) {
+        if (credit_ != 0 && ready[lane_]) {
+            --credit_;
+            return lane_;
+        }
+        lane_ = (lane_ + 1) % kPriorityCount;
+        credit_ = weights_[lane_];
+    }
+    return kPriorityCount;
+}
+
+EventQueue::EventQueue(Backend backend, std::size_t ringCapacity)
+    : EventQueue([&]() {
+          Options options;
+          options.backend = backend;
+          options.ringCapacity = ringCapacity;
+          return options;
+      }()) {
+}
+
+EventQueue::EventQueue(const Options &options)
+    : options_(options), payloadUpstream_(options.numaNode), payloadArena_(&payloadUpstream_),
+      scheduler_(options.dispatchPolicy, options.laneWeights), timers_(options.timerResolution) {
+    if (options_.backend != Backend::Mutex) {
+        if (options_.overflowPolicy == OverflowPolicy::DropOldest) {
+            throw std::invalid_argument("EventQueue: DropOldest requires the Mutex backend");
+        }
+        for (auto &ring : rings_) {
+            ring = std::make_unique<MpscRingBuffer<QueuedEvent>>(ringCapacity());
+            bindStorage(ring->storage());
+        }
+        if (options_.backend == Backend::ShardedSpsc) {
+            // Sized once, so the consumer can walk it while producers register.
+            producerLanes_.resize(options_.maxProducers);
+            producerBudget_.resize(options_.maxProducers);
+        }
+    } else if (options_.capacity != 0) {
+        // Allocate the bounded lanes (and the batch buffers swapped with them) up front.
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            lanes_[lane].reserve(options_.capacity);
+            spareBatch_[lane].reserve(options_.capacity);
+            bindStorage(lanes_[lane].storage());
+            bindStorage(spareBatch_[lane].storage());
+        }
+    }
+}
+
+EventQueue::Backend EventQueue::backend() const {
+    return options_.backend;
+}
+
+void EventQueue::bindStorage(std::span<const std::byte> storage) {
+    if (options_.numaNode >= 0) {
+        bindToNumaNode(storage.data(), storage.size(), options_.numaNode);
+    }
+}
+
+std::size_t EventQueue::ringCapacity() const {
+    return options_.capacity != 0 ? options_.capacity : options_.ringCapacity;
+}
+
+EventQueue::Producer EventQueue::registerProducer() {
+    if (options_.backend != Backend::ShardedSpsc) {
+        throw std::logic_error("EventQueue: registerProducer() requires the ShardedSpsc backend");
+    }
+    std::lock_guard<std::mutex> lock(registerMutex_);
+    const std::size_t index = producerCount_.load(std::memory_order_relaxed);
+    if (index == producerLanes_.size()) {
+        throw std::length_error("EventQueue: too many registered producers");
+    }
+    producerLanes_[index] = std::make_unique<Producer::Lane>(ringCapacity());
+    bindStorage(producerLanes_[index]->ring.storage());
+    // Publish the fully constructed lane to the consumer.
+    producerCount_.store(index + 1, std::memory_order_release);
+    return Producer(*this, *producerLanes_[index]);
+}
+
+bool EventQueue::pushToProducerLane(Producer::Lane &lane, Event &&event) {
+    SequencedEvent entry;
+    if (options_.producerOrdering == ProducerOrdering::GlobalSequence) {
+        entry.sequence = nextSequence_.fetch_add(1, std::memory_order_relaxed);
+    }
+    entry.event = std::move(event);
+    entry.stamp = EnqueueStamp::now();
+    if (!lane.ring.tryPush(std::move(entry))) {
+        if (options_.overflowPolicy != OverflowPolicy::Block) {
+            // Leave a refused event with the caller, as pushEvent() does.
+            if (options_.overflowPolicy == OverflowPolicy::FailFast) {
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                event = std::move(entry.event);
+            } else {
+                droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+        waitForRingSpace(lane.ring, entry);
+    }
+    metrics_.recordEnqueue();
+    notifyConsumer();
+    return true;
+}
+
+bool EventQueue::pushEvent(Event &&event, Priority priority) {
+    return enqueue(std::move(event), priority, options_.overflowPolicy);
+}
+
+bool EventQueue::tryPush(Event &&event, Priority priority) {
+    return enqueue(std::move(event), priority, OverflowPolicy::FailFast);
+}
+
+bool EventQueue::enqueue(Event &&event, Priority priority, OverflowPolicy policy) {
+    const auto lane = static_cast<std::size_t>(priority);
+    QueuedEvent entry{std::move(event), EnqueueStamp::now()};
+    if (options_.backend != Backend::Mutex) {
+        // The ring is always bounded; tryPush() only consumes the entry on success.
+        if (!rings_[lane]->tryPush(std::move(entry))) {
+            if (policy == OverflowPolicy::DropNewest) {
+                droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (policy == OverflowPolicy::FailFast) {
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                event = std::move(entry.event); // Leave the refused event with the caller.
+                return false;
+            }
+            // Block: park until the consumer frees a slot.
+            waitForRingSpace(*rings_[lane], entry);
+        }
+    } else {
+        QueuedEvent evicted; // Destroyed after the lock is released.
+        // Lock the mutex to ensure exclusive access to the queue.
+        std::unique_lock<std::mutex> lock(mutex_);
+        CircularBuffer<QueuedEvent> &queue = lanes_[lane];
+        if (options_.capacity != 0 && queue.size() >= options_.capacity) {
+            switch (policy) {
+            case OverflowPolicy::Block:
+                ++blockedProducers_;
+                notFullCv_.wait(lock, [&]() { return queue.size() < options_.capacity; });
+                --blockedProducers_;
+                break;
+            case OverflowPolicy::FailFast:
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                event = std::move(entry.event);
+                return false;
+            case OverflowPolicy::DropOldest:
+                droppedOldest_.fetch_add(1, std::memory_order_relaxed);
+                metrics_.recordDrop();
+                evicted = std::move(queue.front());
+                queue.pop();
+                break;
+            case OverflowPolicy::DropNewest:
+                droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+                evicted = std::move(entry);
+                return false;
+            }
+        }
+        queue.push(std::move(entry));
+    }
+    metrics_.recordEnqueue();
+    notifyConsumer();
+    return true;
+}
+
+bool EventQueue::pushCoalesced(std::uint64_t key, Event &&event, Priority priority) {
+    {
+        std::lock_guard<std::mutex> lock(coalesceMutex_);
+        auto [it, inserted] = coalesced_.try_emplace(key);
+        it->second = std::move(event);
+        if (!inserted) {
+            return true; // Replaced in place: the pending dispatch will run the new event.
+        }
+    }
+    // Push outside coalesceMutex_: a blocking push must not hold up running dispatches.
+    return pushEvent(Event(std::in_place_type<CoalescedDispatch>, *this, key), priority);
+}
+
+EventQueue::TimerId EventQueue::scheduleAfter(std::chrono::nanoseconds delay, Event &&event) {
+    return addTimer(std::chrono::steady_clock::now() + delay, std::move(event),
+                    std::chrono::nanoseconds::zero());
+}
+
+EventQueue::TimerId EventQueue::scheduleAt(std::chrono::steady_clock::time_point when, Event &&event) {
+    return addTimer(when, std::move(event), std::chrono::nanoseconds::zero());
+}
+
+EventQueue::TimerId EventQueue::schedulePeriodic(std::chrono::nanoseconds period, Event &&event) {
+    return addTimer(std::chrono::steady_clock::now() + period, std::move(event), period);
+}
+
+bool EventQueue::cancelTimer(TimerId id) {
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    const bool cancelled = timers_.cancel(id);
+    timerCount_.store(timers_.size(), std::memory_order_relaxed);
+    return cancelled;
+}
+
+std::size_t EventQueue::pendingTimers() const {
+    return timerCount_.load(std::memory_order_relaxed);
+}
+
+EventQueue::TimerId EventQueue::addTimer(std::chrono::steady_clock::time_point when, Event &&event,
+                                         std::chrono::nanoseconds period) {
+    TimerId id;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        id = timers_.schedule(when, std::move(event), period);
+        timerCount_.store(timers_.size(), std::memory_order_relaxed);
+    }
+    // A parked consumer may be sleeping past the new expiry; let it recompute its deadline.
+    notifyConsumer();
+    return id;
+}
+
+std::size_t EventQueue::runDueTimers() {
+    if (timerCount_.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    std::vector<Timers::Expired> expired;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timers_.advance(std::chrono::steady_clock::now(), expired);
+    }
+    if (expired.empty()) {
+        return 0;
+    }
+    // Run the callbacks unlocked so they can schedule or cancel timers themselves.
+    for (auto &timer : expired) {
+        metrics_.time([&timer]() { runEvent(timer.callback); });
+    }
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    for (auto &timer : expired) {
+        if (timer.periodic) {
+            timers_.rearm(timer.id, std::move(timer.callback));
+        }
+    }
+    timerCount_.store(timers_.size(), std::memory_order_relaxed);
+    return expired.size();
+}
+
+std::chrono::steady_clock::time_point EventQueue::nextTimerExpiry() const {
+    if (timerCount_.load(std::memory_order_relaxed) == 0) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    return timers_.nextExpiry().value_or(std::chrono::steady_clock::time_point::max());
+}
+
+void EventQueue::processEvents(DrainMode mode) {
+    if (mode == DrainMode::Batch && options_.backend == Backend::Mutex) {
+        runDueTimers();
+        processBatch();
+        return;
+    }
+    ProcessLimit unlimited;
+    drain(mode, unlimited);
+}
+
+EventQueue::ProcessResult EventQueue::processFor(std::chrono::steady_clock::time_point deadline) {
+    ProcessLimit limit(SIZE_MAX, deadline, options_.deadlineCheckInterval);
+    const std::size_t timers = drain(DrainMode::PerEvent, limit);
+    return ProcessResult{timers + limit.processed(), pendingEvents()};
+}
+
+EventQueue::ProcessResult EventQueue::processFor(std::chrono::nanoseconds budget) {
+    return processFor(std::chrono::steady_clock::now() + budget);
+}
+
+EventQueue::ProcessResult EventQueue::processUpTo(std::size_t maxEvents) {
+    ProcessLimit limit(maxEvents, std::chrono::steady_clock::time_point::max(), 1);
+    const std::size_t timers = drain(DrainMode::PerEvent, limit);
+    return ProcessResult{timers + limit.processed(), pendingEvents()};
+}
+
+std::size_t EventQueue::drain(DrainMode mode, ProcessLimit &limit) {
+    metrics_.sampleDepth();
+    const std::size_t timers = runDueTimers();
+    if (options_.backend != Backend::Mutex) {
+        processRing(mode, limit);
+        if (options_.backend == Backend::ShardedSpsc) {
+            processProducerLanes(mode, limit);
+        }
+        return timers;
+    }
+    while (limit.allows()) {
+        QueuedEvent entry;
+        bool wakeProducers = false;
         {
             // Lock the mutex to safely check and modify the queue.
             std::lock_guard<std::mutex> lock(mutex_);
-            if (events_.empty()) {
+            std::array<bool, kPriorityCount> ready{};
+            for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+                ready[lane] = !lanes_[lane].empty();
+            }
+            const std::size_t lane = scheduler_.next(ready);
+            if (lane == kPriorityCount) {
                 break; // Exit the loop if no events remain.
             }
-            // Retrieve the event at the front of the queue.
-            event = events_.front();
-            events_.pop();
+            // Retrieve the event at the front of the chosen lane.
+            entry = std::move(lanes_[lane].front());
+            lanes_[lane].pop();
+            wakeProducers = blockedProducers_ != 0;
+        }
+        if (wakeProducers) {
+            notFullCv_.notify_all();
         }
         // Execute the event outside of the mutex lock to avoid holding the lock during execution.
-        if (event) {
-            event();
+        dispatch(entry.event, entry.stamp);
+        limit.consume();
+    }
+    return timers;
+}
+
+void EventQueue::processRing(DrainMode mode, ProcessLimit &limit) {
+    // Single consumer: pop without locking until no published event remains. In batch
+    // mode, stop after the events that were already queued when the drain started.
+    std::array<std::size_t, kPriorityCount> budget;
+    for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+        budget[lane] = mode == DrainMode::Batch ? rings_[lane]->sizeApprox() : SIZE_MAX;
+    }
+    QueuedEvent entry;
+    while (limit.allows()) {
+        std::array<bool, kPriorityCount> ready{};
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            ready[lane] = budget[lane] != 0 && !rings_[lane]->empty();
+        }
+        const std::size_t lane = scheduler_.next(ready);
+        if (lane == kPriorityCount || !rings_[lane]->tryPop(entry)) {
+            return;
+        }
+        --budget[lane];
+        notifyBlockedProducers();
+        dispatch(entry.event, entry.stamp);
+        limit.consume();
+    }
+}
+
+void EventQueue::processProducerLanes(DrainMode mode, ProcessLimit &limit) {
+    const std::size_t count = producerCount_.load(std::memory_order_acquire);
+    if (count == 0) {
+        return;
+    }
+    // In batch mode, stop after the events that were already queued when the drain started.
+    std::vector<std::size_t> &budget = producerBudget_;
+    for (std::size_t i = 0; i < count; ++i) {
+        budget[i] = mode == DrainMode::Batch ? producerLanes_[i]->ring.sizeApprox() : SIZE_MAX;
+    }
+    SequencedEvent entry;
+    if (options_.producerOrdering == ProducerOrdering::GlobalSequence) {
+        // Merge the rings: always run the visible event with the lowest sequence number.
+        while (limit.allows()) {
+            std::size_t best = count;
+            std::uint64_t bestSequence = UINT64_MAX;
+            for (std::size_t i = 0; i < count; ++i) {
+                const SequencedEvent *front = budget[i] != 0 ? producerLanes_[i]->ring.front() : nullptr;
+                if (front != nullptr && front->sequence < bestSequence) {
+                    best = i;
+                    bestSequence = front->sequence;
+                }
+            }
+            if (best == count || !producerLanes_[best]->ring.tryPop(entry)) {
+                return;
+            }
+            --budget[best];
+            notifyBlockedProducers();
+            dispatch(entry.event, entry.stamp);
+            limit.consume();
+        }
+        return;
+    }
+    // Round-robin: take a short burst from each ring in turn, starting after the ring that
+    // was served first last time, until a full pass finds nothing to run.
+    constexpr std::size_t kBurst = 32;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (std::size_t n = 0; n < count; ++n) {
+            const std::size_t i = (producerCursor_ + n) % count;
+            for (std::size_t k = 0; k < kBurst && budget[i] != 0 && limit.allows() &&
+                                    producerLanes_[i]->ring.tryPop(entry);
+                 ++k) {
+                --budget[i];
+                progress = true;
+                notifyBlockedProducers();
+                dispatch(entry.event, entry.stamp);
+                limit.consume();
+            }
         }
+        producerCursor_ = (producerCursor_ + 1) % count;
     }
 }
 
+void EventQueue::processBatch() {
+    metrics_.sampleDepth();
+    Lanes batch;
+    bool wakeProducers = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            if (options_.capacity != 0 && spareBatch_[lane].capacity() < options_.capacity) {
+                // Another batch drain (on another thread, or the one running this handler)
+                // holds the spare buffers. Swapping in an empty one would make the bounded
+                // lane reallocate, so run this batch in place instead.
+                std::array<std::size_t, kPriorityCount> budget;
+                for (std::size_t i = 0; i < kPriorityCount; ++i) {
+                    budget[i] = lanes_[i].size();
+                }
+                lock.unlock();
+                processBatchInPlace(budget);
+                return;
+            }
+        }
+        // Take the recycled buffers and exchange them with the pending events in one go.
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            batch[lane].swap(spareBatch_[lane]);
+            batch[lane].swap(lanes_[lane]);
+        }
+        wakeProducers = blockedProducers_ != 0;
+    }
+    if (wakeProducers) {
+        notFullCv_.notify_all();
+    }
+    // Run the batch without holding the lock; new pushes land in lanes_.
+    LaneScheduler scheduler(options_.dispatchPolicy, options_.laneWeights);
+    while (true) {
+        std::array<bool, kPriorityCount> ready{};
+        for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+            ready[lane] = !batch[lane].empty();
+        }
+        const std::size_t lane = scheduler.next(ready);
+        if (lane == kPriorityCount) {
+            break;
+        }
+        QueuedEvent entry = std::move(batch[lane].front());
+        batch[lane].pop();
+        dispatch(entry.event, entry.stamp);
+    }
+    // Hand the (now empty) storage back so the next drain reuses its capacity.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+        if (batch[lane].capacity() > spareBatch_[lane].capacity()) {
+            spareBatch_[lane].swap(batch[lane]);
+        }
+    }
+}
+
+void EventQueue::processBatchInPlace(std::array<std::size_t, kPriorityCount> budget) {
+    LaneScheduler scheduler(options_.dispatchPolicy, options_.laneWeights);
+    while (true) {
+        QueuedEvent entry;
+        bool wakeProducers = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::array<bool, kPriorityCount> ready{};
+            for (std::size_t lane = 0; lane < kPriorityCount; ++lane) {
+                // Other consumers may have taken some of the counted events meanwhile.
+                ready[lane] = budget[lane] != 0 && !lanes_[lane].empty();
+            }
+            const std::size_t lane = scheduler.next(ready);
+            if (lane == kPriorityCount) {
+                break;
+            }
+            entry = std::move(lanes_[lane].front());
+            lanes_[lane].pop();
+            --budget[lane];
+            wakeProducers = blockedProducers_ != 0;
+        }
+        if (wakeProducers) {
+            notFullCv_.notify_all();
+        }
+        dispatch(entry.event, entry.stamp);
+    }
+}
+
+void EventQueue::waitAndProcess(DrainMode mode) {
+    waitForWork(std::chrono::steady_clock::time_point::max());
+    processEvents(mode);
+}
+
+bool EventQueue::waitFor(std::chrono::nanoseconds timeout) {
+    return waitForWork(std::chrono::steady_clock::now() + timeout);
+}
+
+bool EventQueue::waitForWork(std::chrono::steady_clock::time_point deadline) {
+    using Clock = std::chrono::steady_clock;
+    // Fast path: no need to park if work is already queued.
+    if (!isEmpty() || nextTimerExpiry() <= Clock::now()) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    // Announce the sleeper before re-checking the queue. Paired with the fence in
+    // notifyConsumer(), either the producer sees the announcement or we see its event.
+    waitingConsumers_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool result = true;
+    while (isEmpty()) {
+        // Re-read the next expiry on every wake-up: a new timer may have moved it earlier.
+        const Clock::time_point timer = nextTimerExpiry();
+        const Clock::time_point now = Clock::now();
+        if (timer <= now) {
+            break;
+        }
+        if (deadline <= now) {
+            result = false;
+            break;
+        }
+        const Clock::time_point wakeAt = std::min(timer, deadline);
+        if (wakeAt == Clock::time_point::max()) {
+            waitCv_.wait(lock);
+        } else {
+            waitCv_.wait_until(lock, wakeAt);
+        }
+    }
+    waitingConsumers_.fetch_sub(1, std::memory_order_relaxed);
+    return result;
+}
+
+void EventQueue::notifyConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // Skip the syscall entirely when no consumer is parked.
+    if (waitingConsumers_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        // Taking the lock orders this notification after the consumer has started waiting.
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    waitCv_.notify_one();
+}
+
+template <typename Ring, typename Entry>
+void EventQueue::waitForRingSpace(Ring &ring, Entry &entry) {
+    // Yield a few times first: a draining consumer usually frees a slot within a time slice,
+    // and every parked producer costs the consumer a wake-up system call.
+    constexpr int kYieldsBeforePark = 64;
+    for (int i = 0; i < kYieldsBeforePark; ++i) {
+        std::this_thread::yield();
+        if (ring.tryPush(std::move(entry))) {
+            return;
+        }
+    }
+    std::unique_lock<std::mutex> lock(ringSpaceMutex_);
+    // Announce the waiter before retrying the push. Paired with the fence in
+    // notifyBlockedProducers(), either the consumer sees the announcement or we see its pop.
+    blockedRingProducers_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ringSpaceCv_.wait(lock, [&]() { return ring.tryPush(std::move(entry)); });
+    blockedRingProducers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventQueue::notifyBlockedProducers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (blockedRingProducers_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        // Taking the lock orders this notification after the producer has started waiting.
+        std::lock_guard<std::mutex> lock(ringSpaceMutex_);
+    }
+    // Wake them all: the freed slot may belong to any lane, and a registered producer only
+    // waits for its own ring.
+    ringSpaceCv_.notify_all();
+}
+
+void EventQueue::dispatch(Event &event, EnqueueStamp stamp) {
+    metrics_.dispatch(stamp, [&event]() { runEvent(event); });
+}
+
+QueueMetricsSnapshot EventQueue::metrics() const {
+    return metrics_.snapshot();
+}
+
+EventQueue::OverflowCounters EventQueue::overflowCounters() const {
+    OverflowCounters counters;
+    counters.droppedOldest = droppedOldest_.load(std::memory_order_relaxed);
+    counters.droppedNewest = droppedNewest_.load(std::memory_order_relaxed);
+    counters.rejected = rejected_.load(std::memory_order_relaxed);
+    return counters;
+}
+
+std::size_t EventQueue::pendingEvents() const {
+    std::size_t count = 0;
+    if (options_.backend != Backend::Mutex) {
+        for (const auto &ring : rings_) {
+            count += ring->sizeApprox();
+        }
+        const std::size_t producers = producerCount_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < producers; ++i) {
+            count += producerLanes_[i]->ring.sizeApprox();
+        }
+        return count;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &lane : lanes_) {
+        count += lane.size();
+    }
+    return count;
+}
+
 bool EventQueue::isEmpty() const {
+    if (options_.backend != Backend::Mutex) {
+        const std::size_t producers = producerCount_.load(std::memory_order_acquire);
+        return std::all_of(rings_.begin(), rings_.end(),
+                           [](const auto &ring) { return ring->empty(); }) &&
+               std::all_of(producerLanes_.begin(), producerLanes_.begin() + static_cast<std::ptrdiff_t>(producers),
+                           [](const auto &lane) { return lane->ring.empty(); });
+    }
     // Lock the mutex to safely access the queue.
     std::lock_guard<std::mutex> lock(mutex_);
-    return events_.empty();
+    return std::all_of(lanes_.begin(), lanes_.end(),
+                       [](const auto &lane) { return lane.empty(); });
 }
 
-} // namespace event_queue
\ No newline at end of file
+} // namespace event_queue
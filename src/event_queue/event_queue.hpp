@@ -6,14 +6,47 @@
  * @brief Declaration of the EventQueue class.
  *
  * This file declares the EventQueue class, which provides a thread-safe mechanism
- * for queuing and processing events. An event is represented as a callable object (using
- * std::function<void()>), allowing the decoupling of event production from event handling.
+ * for queuing and processing events. An event is represented as a move-only callable object
+ * (a SmallFunction<void()>), allowing the decoupling of event production from event handling.
  * This is useful in event-driven architectures, game loops, or any asynchronous application.
  */
 
-#include <queue>
-#include <functional>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <cstring>
+#include <memory_resource>
 #include <mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "circular_buffer.hpp"
+#include "mpsc_ring_buffer.hpp"
+#include "payload_arena.hpp"
+#include "queue_metrics.hpp"
+#include "small_function.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "thread_affinity.hpp"
+#include "timing_wheel.hpp"
+
+/**
+ * @brief Inline capacity, in bytes, of EventQueue::Event.
+ *
+ * Events whose callable fits in this many bytes are stored without any heap allocation.
+ * Values between 48 and 64 keep an event within one or two cache lines; define the macro
+ * before including this header (or on the compiler command line) to override it.
+ */
+#ifndef EVENT_QUEUE_TASK_CAPACITY
+#define EVENT_QUEUE_TASK_CAPACITY 56
+#endif
 
 /**
  * @namespace event_queue
@@ -21,8 +54,8 @@
  *
  * This namespace provides functionality for managing asynchronous events using a FIFO queue.
  * The primary component is the EventQueue class, which allows events, represented as callable objects,
- * to be enqueued and processed in a thread-safe manner. It leverages standard C++ libraries such as
- * std::queue, std::function, and std::mutex to ensure safe access across multiple threads.
+ * to be enqueued and processed in a thread-safe manner. It relies on std::mutex or a lock-free
+ * ring buffer to ensure safe access across multiple threads.
  *
  * The event queue is particularly useful for decoupling event production from event processing,
  * making it a valuable tool in event-driven architectures, game loops, and other asynchronous applications.
@@ -33,8 +66,13 @@ namespace event_queue {
  * @brief A thread-safe event queue.
  *
  * The EventQueue class allows you to enqueue events (callable objects) and later process
- * them sequentially (in a FIFO manner). It uses a mutex to ensure that operations on the queue
- * are safe across multiple threads.
+ * them sequentially (in a FIFO manner). By default it uses a mutex to ensure that operations
+ * on the queue are safe across multiple threads. Alternatively, it can be backed by a bounded
+ * lock-free ring buffer (see Backend::LockFreeRing) so that producers never contend on a lock.
+ *
+ * Events are pushed into one of a fixed number of priority lanes (see Priority). Each lane is
+ * a FIFO with O(1) push; processEvents() picks the lane to serve next with either strict
+ * priority or weighted round-robin (see DispatchPolicy).
  */
 class EventQueue {
 public:
@@ -42,25 +80,530 @@ public:
      * @brief Type alias for an event.
      *
      * An event is defined as a callable object that takes no arguments and returns void.
+     * It is move-only and stores callables of up to EVENT_QUEUE_TASK_CAPACITY bytes inline,
+     * so such events are never heap-allocated between push and dispatch.
+     */
+    using Event = SmallFunction<void(), EVENT_QUEUE_TASK_CAPACITY>;
+
+    /**
+     * @brief Selects the storage used to hold pending events.
+     */
+    enum class Backend {
+        /// Unbounded CircularBuffer protected by a std::mutex. processEvents() may be called
+        /// from any thread.
+        Mutex,
+        /// Bounded lock-free multi-producer/single-consumer ring buffer. pushEvent() may be
+        /// called from any thread, but processEvents() must only be called from one consumer
+        /// thread at a time. What pushEvent() does when the ring is full is selected by
+        /// OverflowPolicy (by default the producer sleeps until space is freed).
+        LockFreeRing,
+        /// One single-producer/single-consumer ring per producer registered with
+        /// registerProducer(), in addition to the LockFreeRing storage used by pushEvent().
+        /// Registered producers share no index or cache line, so their pushes never contend.
+        /// processEvents() must only be called from one consumer thread at a time.
+        ShardedSpsc
+    };
+
+    /**
+     * @brief Selects how processEvents() orders events from different registered producers.
+     */
+    enum class ProducerOrdering {
+        /// Events are FIFO per producer; producers are served round-robin. Pushes touch only
+        /// the producer's own ring.
+        None,
+        /// Events are FIFO per producer and also carry a global sequence number, and each
+        /// drain runs the events it finds in sequence order across producers. This costs one
+        /// shared atomic increment per push.
+        GlobalSequence
+    };
+
+    /**
+     * @brief Selects how processEvents() takes events out of the queue.
+     */
+    enum class DrainMode {
+        /// Pop and run one event at a time until the queue is empty. Events pushed while
+        /// draining (including by the running handlers) are run by the same call.
+        PerEvent,
+        /// Move every pending event out at once and run them without touching the queue's
+        /// lock. Events pushed while the batch runs are left for the next call.
+        Batch
+    };
+
+    /**
+     * @brief The priority lane an event is pushed into.
+     *
+     * Events are FIFO within a lane. Control events such as shutdown, configuration reloads or
+     * heartbeats belong in High so they do not wait behind bulk traffic in Normal or Low.
+     */
+    enum class Priority {
+        High,   ///< Served first.
+        Normal, ///< The default lane.
+        Low     ///< Served last (bulk or background work).
+    };
+
+    /**
+     * @brief Number of priority lanes.
+     */
+    static constexpr std::size_t kPriorityCount = 3;
+
+    /**
+     * @brief Selects how processEvents() chooses between non-empty priority lanes.
+     */
+    enum class DispatchPolicy {
+        /// Always serve the highest-priority non-empty lane. Lower lanes can starve while
+        /// higher ones are kept busy.
+        Strict,
+        /// Weighted round-robin: visit the lanes from High to Low, running up to the lane's
+        /// weight in events from each before moving on, so every lane makes progress.
+        Weighted
+    };
+
+    /**
+     * @brief Selects what pushEvent() does when a bounded lane is full.
+     */
+    enum class OverflowPolicy {
+        /// Block the producer until the consumer makes room. On the lock-free backends the
+        /// producer yields briefly and then sleeps until a pop wakes it.
+        Block,
+        /// Refuse the event: pushEvent() returns false and leaves it with the caller.
+        FailFast,
+        /// Evict the oldest event of the lane to make room for the new one (Mutex backend only).
+        DropOldest,
+        /// Discard the new event: pushEvent() returns false and destroys it.
+        DropNewest
+    };
+
+    /**
+     * @brief Number of events lost or refused because a bounded lane was full.
+     */
+    struct OverflowCounters {
+        std::uint64_t droppedOldest = 0; ///< Queued events evicted under OverflowPolicy::DropOldest.
+        std::uint64_t droppedNewest = 0; ///< New events discarded under OverflowPolicy::DropNewest.
+        std::uint64_t rejected = 0;      ///< Pushes refused under OverflowPolicy::FailFast or by tryPush().
+    };
+
+    /**
+     * @brief What a budgeted drain (processFor() or processUpTo()) did.
+     */
+    struct ProcessResult {
+        std::size_t processed = 0; ///< Events (including expired timers) run by the call.
+        std::size_t remaining = 0; ///< Events still queued when the call returned (approximate
+                                   ///< for the lock-free backends).
+    };
+
+    /**
+     * @brief Whether the queue was compiled with EVENT_QUEUE_ENABLE_METRICS.
+     */
+    static constexpr bool kMetricsEnabled = EVENT_QUEUE_ENABLE_METRICS != 0;
+
+    /**
+     * @brief Default number of slots allocated for the LockFreeRing backend.
+     */
+    static constexpr std::size_t kDefaultRingCapacity = 1u << 16;
+
+    /**
+     * @brief Handle to a timer created by scheduleAfter(), scheduleAt() or schedulePeriodic().
+     */
+    using TimerId = event_queue::TimerId;
+
+    /**
+     * @brief Construction-time configuration of an EventQueue.
+     */
+    struct Options {
+        /// The storage used for pending events.
+        Backend backend = Backend::Mutex;
+        /// Slots per priority lane for Backend::LockFreeRing (rounded up to a power of two).
+        std::size_t ringCapacity = kDefaultRingCapacity;
+        /// How processEvents() chooses between priority lanes.
+        DispatchPolicy dispatchPolicy = DispatchPolicy::Strict;
+        /// Events run per visit of each lane (High, Normal, Low) under DispatchPolicy::Weighted.
+        /// Zero weights are treated as one.
+        std::array<unsigned, kPriorityCount> laneWeights{8, 4, 1};
+        /// Maximum number of pending events per priority lane; zero means unbounded (Mutex
+        /// backend). A bounded lane's storage is allocated up front and never grows. For
+        /// Backend::LockFreeRing, a non-zero value replaces ringCapacity.
+        std::size_t capacity = 0;
+        /// What pushEvent() does when a lane is full. DropOldest requires the Mutex backend.
+        OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+        /// Maximum number of producers that can be registered with Backend::ShardedSpsc.
+        std::size_t maxProducers = 64;
+        /// Ordering across registered producers (Backend::ShardedSpsc).
+        ProducerOrdering producerOrdering = ProducerOrdering::None;
+        /// processFor() reads the clock before every this-many events (at least 1).
+        std::size_t deadlineCheckInterval = 16;
+        /// Granularity of the timing wheel. Timers never fire early and at most one tick late.
+        std::chrono::nanoseconds timerResolution = std::chrono::milliseconds(1);
+        /// NUMA node to keep the queue's storage on, normally the consumer's (see
+        /// CpuTopology::nodeOf()). The lock-free rings, registered producers' rings, bounded
+        /// Mutex lanes and payload arena chunks are bound to it. -1 leaves placement to the
+        /// operating system.
+        int numaNode = -1;
+    };
+
+    /**
+     * @brief Constructs an empty event queue.
+     *
+     * @param backend The storage used for pending events.
+     * @param ringCapacity The capacity of each ring buffer when @p backend is
+     *        Backend::LockFreeRing (rounded up to a power of two). Ignored otherwise.
+     */
+    explicit EventQueue(Backend backend = Backend::Mutex,
+                        std::size_t ringCapacity = kDefaultRingCapacity);
+
+    /**
+     * @brief Constructs an empty event queue with the given options.
+     *
+     * @param options The queue configuration.
+     * @throws std::invalid_argument if OverflowPolicy::DropOldest is combined with
+     *         Backend::LockFreeRing or Backend::ShardedSpsc, whose producers cannot evict events.
+     */
+    explicit EventQueue(const Options &options);
+
+    /**
+     * @brief Returns the storage backend selected at construction.
+     */
+    Backend backend() const;
+
+    class Producer;
+
+    /**
+     * @brief Gives the calling producer its own ring (Backend::ShardedSpsc).
+     *
+     * The returned handle must only be used by one thread at a time. Its ring lives as long
+     * as the queue; registration is meant for a fixed set of long-lived producer threads.
+     *
+     * @return A handle whose push() writes to the new ring.
+     * @throws std::logic_error if the backend is not Backend::ShardedSpsc.
+     * @throws std::length_error if Options::maxProducers producers are already registered.
      */
-    using Event = std::function<void()>;
+    Producer registerProducer();
 
     /**
      * @brief Enqueues an event.
      *
      * Adds an event to the queue. The event will be executed when processEvents() is called.
+     * If the lane is full, the configured OverflowPolicy decides what happens. Under
+     * OverflowPolicy::Block, a handler that pushes into a full lane of its own queue waits for
+     * another consumer; such handlers should use tryPush() instead.
+     *
+     * @param event The event to enqueue. It is moved into the queue unless it is refused
+     *        under OverflowPolicy::FailFast.
+     * @param priority The lane to push the event into.
+     * @return true if the event was enqueued, false if it was refused or discarded.
+     */
+    bool pushEvent(Event &&event, Priority priority = Priority::Normal);
+
+    /**
+     * @brief Enqueues any callable as an event.
+     *
+     * The callable is copied or moved into an Event, without allocating if it fits the
+     * inline buffer.
+     *
+     * @param callable The callable to enqueue.
+     * @param priority The lane to push the event into.
+     */
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, Event> && std::is_constructible_v<Event, F>)
+    bool pushEvent(F &&callable, Priority priority = Priority::Normal) {
+        return pushEvent(Event(std::forward<F>(callable)), priority);
+    }
+
+    /**
+     * @brief Enqueues an event unless its lane is full, whatever the OverflowPolicy.
+     *
+     * @param event The event to enqueue. It is left untouched if the push fails.
+     * @param priority The lane to push the event into.
+     * @return true if the event was enqueued, false if the lane was full.
+     */
+    bool tryPush(Event &&event, Priority priority = Priority::Normal);
+
+    /**
+     * @brief Constructs a callable of type @p F directly inside a new event and enqueues it.
+     *
+     * @param args The arguments forwarded to the constructor of @p F.
+     */
+    template <typename F, typename... Args>
+    bool emplaceEvent(Args &&...args) {
+        return pushEvent(Event(std::in_place_type<F>, std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief A registered producer's handle for pushing into its own ring.
+     */
+    class Producer {
+    public:
+        /**
+         * @brief Enqueues an event on this producer's ring.
+         *
+         * Producer rings are drained after the priority lanes fed by pushEvent(). A full ring
+         * is handled according to the queue's OverflowPolicy.
+         *
+         * @param event The event to enqueue.
+         * @return true if the event was enqueued, false if it was refused or discarded.
+         */
+        bool push(Event &&event) { return queue_->pushToProducerLane(*lane_, std::move(event)); }
+
+        /**
+         * @brief Enqueues any callable as an event on this producer's ring.
+         */
+        template <typename F>
+            requires(!std::is_same_v<std::decay_t<F>, Event> && std::is_constructible_v<Event, F>)
+        bool push(F &&callable) {
+            return push(Event(std::forward<F>(callable)));
+        }
+
+    private:
+        friend class EventQueue;
+
+        struct Lane;
+
+        Producer(EventQueue &queue, Lane &lane) : queue_(&queue), lane_(&lane) {}
+
+        EventQueue *queue_;
+        Lane *lane_;
+    };
+
+    /**
+     * @brief Awaitable that resumes the awaiting coroutine from processEvents(); see schedule().
+     */
+    class ScheduleAwaitable {
+    public:
+        ScheduleAwaitable(EventQueue &queue, Priority priority) : queue_(queue), priority_(priority) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        /**
+         * @brief Pushes an event that resumes @p handle.
+         *
+         * @return false (resuming the coroutine immediately on the current thread) if the
+         *         event was refused by a full bounded queue.
+         */
+        bool await_suspend(std::coroutine_handle<> handle) {
+            // A coroutine handle fits the event's inline buffer: resuming never allocates.
+            return queue_.pushEvent([handle]() { handle.resume(); }, priority_);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        EventQueue &queue_;
+        Priority priority_;
+    };
+
+    /**
+     * @brief Returns an awaitable that moves a coroutine onto the thread running processEvents().
+     *
+     * `co_await queue.schedule()` suspends the coroutine and enqueues an event that resumes
+     * it. Each step of a multi-stage coroutine therefore costs one inline event and no heap
+     * allocation, unlike a chain of nested lambdas. A coroutine whose event is still queued
+     * when the queue is destroyed is never resumed, and its frame is not freed.
      *
+     * @param priority The lane of the event that resumes the coroutine.
+     */
+    ScheduleAwaitable schedule(Priority priority = Priority::Normal) {
+        return ScheduleAwaitable(*this, priority);
+    }
+
+    /**
+     * @brief Enqueues an event that supersedes any still-pending event pushed with the same key.
+     *
+     * If an event for @p key is queued and has not started running, it is replaced by
+     * @p event, which then runs at the original event's queue position (and in its lane);
+     * otherwise @p event is enqueued like pushEvent() would. This suits "state X changed"
+     * notifications where only the latest one matters. The key lookup is a hash-table access.
+     *
+     * If a full bounded queue refuses the push, the pending event for @p key (including one
+     * installed concurrently by another producer) is discarded.
+     *
+     * @param key Identifies the events that supersede each other.
      * @param event The event to enqueue.
+     * @param priority The lane used if no event for @p key is pending.
+     * @return true if the event was enqueued or replaced a pending one.
+     */
+    bool pushCoalesced(std::uint64_t key, Event &&event, Priority priority = Priority::Normal);
+
+    /**
+     * @brief Enqueues any callable as a coalesced event; see pushCoalesced(std::uint64_t, Event &&, Priority).
+     */
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, Event> && std::is_constructible_v<Event, F>)
+    bool pushCoalesced(std::uint64_t key, F &&callable, Priority priority = Priority::Normal) {
+        return pushCoalesced(key, Event(std::forward<F>(callable)), priority);
+    }
+
+    /**
+     * @brief Enqueues @p handler together with a copy of @p payload held in the queue's arena.
+     *
+     * The copy is carved from payloadResource() instead of the global heap and is released when
+     * the event has run (or is discarded), so the chunks used by a drained batch are reclaimed
+     * as a whole and reused by the next one. Payloads larger than
+     * PayloadArena::kMaxSmallAllocation fall back to the arena's upstream resource.
+     *
+     * @param payload The bytes to copy. The caller's buffer may be reused as soon as this returns.
+     * @param handler Called on the consumer thread with a std::span<const std::byte> over the copy.
+     * @param priority The lane to enqueue the event in.
+     * @return true if the event was enqueued, false if the overflow policy refused it.
+     */
+    template <typename Handler>
+        requires std::is_invocable_v<std::decay_t<Handler> &, std::span<const std::byte>>
+    bool pushPayloadEvent(std::span<const std::byte> payload, Handler &&handler,
+                          Priority priority = Priority::Normal) {
+        return pushEvent(PayloadEvent<std::decay_t<Handler>>(payloadArena_, payload,
+                                                             std::forward<Handler>(handler)),
+                         priority);
+    }
+
+    /**
+     * @brief Returns the arena backing pushPayloadEvent(), for std::pmr containers captured by events.
+     *
+     * Memory obtained from it must be released before the queue is destroyed.
+     */
+    std::pmr::memory_resource *payloadResource() { return &payloadArena_; }
+
+    /**
+     * @brief Returns a snapshot of the payload arena's memory use and fragmentation.
+     */
+    PayloadArena::Stats payloadStats() const { return payloadArena_.stats(); }
+
+    /**
+     * @brief Runs @p event once, after @p delay has elapsed.
+     *
+     * Timers are kept in a hierarchical timing wheel rather than in the queue, so a pending
+     * timer costs no CPU until it expires. Expired timers are run by the next processEvents()
+     * call (before the queued events), and blocking waits wake up when the next timer is due.
+     *
+     * @param delay How long to wait before running the event.
+     * @param event The event to run.
+     * @return A handle that can be passed to cancelTimer().
+     */
+    TimerId scheduleAfter(std::chrono::nanoseconds delay, Event &&event);
+
+    /**
+     * @brief Runs @p event once, at or shortly after @p when.
+     *
+     * @param when The time at which the event becomes due.
+     * @param event The event to run.
+     * @return A handle that can be passed to cancelTimer().
+     */
+    TimerId scheduleAt(std::chrono::steady_clock::time_point when, Event &&event);
+
+    /**
+     * @brief Runs @p event every @p period, starting one period from now, until cancelled.
+     *
+     * The schedule is kept at a fixed rate: if processing falls behind by more than a period,
+     * the missed runs are skipped rather than run back to back.
+     *
+     * @param period The interval between runs.
+     * @param event The event to run.
+     * @return A handle that can be passed to cancelTimer().
+     */
+    TimerId schedulePeriodic(std::chrono::nanoseconds period, Event &&event);
+
+    /**
+     * @brief Cancels a timer in O(1).
+     *
+     * May be called from any thread, including from the timer's own event.
+     *
+     * @param id The handle returned when the timer was scheduled.
+     * @return true if the timer was pending and will not run again, false if it had already
+     *         fired (one-shot) or been cancelled.
+     */
+    bool cancelTimer(TimerId id);
+
+    /**
+     * @brief Returns the number of timers that are scheduled and not yet fired or cancelled.
      */
-    void pushEvent(const Event &event);
+    std::size_t pendingTimers() const;
 
     /**
      * @brief Processes all events in the queue.
      *
-     * Executes all events in the queue in FIFO order. After processing, the queue is empty.
-     * This operation is thread-safe.
+     * Runs every timer that has expired, then executes all events in the queue, in FIFO order within each priority lane and in the
+     * lane order chosen by the dispatch policy. This operation is thread-safe.
+     *
+     * In DrainMode::PerEvent (the default), the queue is locked once per event and the call
+     * returns only when the queue is empty. In DrainMode::Batch, the Mutex backend swaps the
+     * whole pending batch into a consumer-local buffer under a single lock acquisition and runs
+     * it unlocked; the buffer's capacity is recycled across drains, so the steady state does
+     * not allocate. Any event pushed after the batch was taken, even by a handler of the batch
+     * itself, is not run by this call but by the next one, and the queue may therefore be
+     * non-empty on return. The LockFreeRing backend applies the same rule by only popping the
+     * events that were present when the drain started, as does a batch drain of a bounded
+     * Mutex queue that overlaps another one (the spare buffer is in use, and swapping in a
+     * new one would reallocate the lane). Note that a High event pushed while a
+     * batch runs waits for the rest of that batch; use PerEvent when high-priority latency
+     * matters more than lock traffic.
+     *
+     * @param mode How events are taken out of the queue.
+     */
+    void processEvents(DrainMode mode = DrainMode::PerEvent);
+
+    /**
+     * @brief Processes events until the queue is empty or @p deadline has passed.
+     *
+     * Runs expired timers and then queued events one at a time, like processEvents() in
+     * DrainMode::PerEvent, but stops once the deadline has passed even if producers keep the
+     * queue non-empty. The clock is only read before every Options::deadlineCheckInterval-th
+     * event, so the call can overrun the deadline by up to that many events (plus the expired
+     * timers, which always all run). A tick loop can bound its per-tick latency with:
+     *
+     * @code
+     * queue.processFor(std::chrono::microseconds(500));
+     * @endcode
+     *
+     * @param deadline The time after which no further event is started.
+     * @return How many events ran and how many are still queued.
+     */
+    ProcessResult processFor(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Processes events for at most @p budget from now; see processFor(time_point).
+     */
+    ProcessResult processFor(std::chrono::nanoseconds budget);
+
+    /**
+     * @brief Processes at most @p maxEvents queued events (after running any expired timers).
+     *
+     * @param maxEvents The maximum number of queued events to run.
+     * @return How many events ran and how many are still queued.
+     */
+    ProcessResult processUpTo(std::size_t maxEvents);
+
+    /**
+     * @brief Blocks until at least one event is queued or a timer is due, then processes events.
+     *
+     * The calling thread sleeps on a condition variable instead of polling isEmpty(); the
+     * first push after it parks wakes it with a single notification, and the sleep is cut
+     * short when the next timer expires. To stop a consumer
+     * blocked here (for example on shutdown), push an event that tells it to exit its loop.
+     *
+     * @param mode How events are taken out of the queue once the wait returns.
+     */
+    void waitAndProcess(DrainMode mode = DrainMode::PerEvent);
+
+    /**
+     * @brief Blocks until at least one event is queued, a timer is due, or @p timeout elapses.
+     *
+     * No event is processed; call processEvents() when this returns true.
+     *
+     * @param timeout The maximum time to wait.
+     * @return true if the queue is non-empty or a timer is due, false if the timeout expired first.
+     */
+    bool waitFor(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Returns how many events the overflow policy has dropped or refused so far.
+     */
+    OverflowCounters overflowCounters() const;
+
+    /**
+     * @brief Returns the queue's depth, high-water mark and latency histograms.
+     *
+     * The per-thread counters are merged on each call, so it is meant for periodic export
+     * rather than for the hot path. Without EVENT_QUEUE_ENABLE_METRICS, every field is zero
+     * and recording costs nothing.
      */
-    void processEvents();
+    QueueMetricsSnapshot metrics() const;
 
     /**
      * @brief Checks whether the event queue is empty.
@@ -70,8 +613,211 @@ public:
     bool isEmpty() const;
 
 private:
-    std::queue<Event> events_;  ///< The underlying queue storing events.
-    mutable std::mutex mutex_;  ///< Mutex to protect access to the event queue.
+    /**
+     * @brief Chooses the lane to serve next according to a DispatchPolicy.
+     */
+    class LaneScheduler {
+    public:
+        LaneScheduler(DispatchPolicy policy, const std::array<unsigned, kPriorityCount> &weights);
+
+        /**
+         * @brief Returns the lane to pop from next, or kPriorityCount if no lane is ready.
+         *
+         * @param ready Which lanes currently have an event to run.
+         */
+        std::size_t next(const std::array<bool, kPriorityCount> &ready);
+
+    private:
+        DispatchPolicy policy_;
+        std::array<unsigned, kPriorityCount> weights_;
+        std::size_t lane_ = 0;  ///< Lane being served (Weighted).
+        unsigned credit_ = 0;   ///< Events left for lane_ in this round (Weighted).
+    };
+
+    /**
+     * @brief An event as stored in a lane, with its push time when metrics are enabled.
+     */
+    struct QueuedEvent {
+        Event event;
+        [[no_unique_address]] EnqueueStamp stamp;
+    };
+
+    using Lanes = std::array<CircularBuffer<QueuedEvent>, kPriorityCount>;
+
+    using Timers = TimingWheel<Event>;
+
+    /**
+     * @brief An event in a producer's ring, stamped for ProducerOrdering::GlobalSequence.
+     */
+    struct SequencedEvent {
+        std::uint64_t sequence = 0;
+        Event event;
+        [[no_unique_address]] EnqueueStamp stamp;
+    };
+
+    class CoalescedDispatch;
+    class ProcessLimit;
+
+    /**
+     * @brief An event owning an arena copy of its payload, which it frees when destroyed.
+     */
+    template <typename Handler>
+    class PayloadEvent {
+    public:
+        template <typename H>
+        PayloadEvent(PayloadArena &arena, std::span<const std::byte> payload, H &&handler)
+            : arena_(&arena), size_(payload.size()), handler_(std::forward<H>(handler)) {
+            data_ = static_cast<std::byte *>(arena.allocate(size_, alignof(std::max_align_t)));
+            if (size_ != 0) {
+                std::memcpy(data_, payload.data(), size_);
+            }
+        }
+
+        PayloadEvent(PayloadEvent &&other) noexcept
+            : arena_(other.arena_),
+              data_(std::exchange(other.data_, nullptr)),
+              size_(other.size_),
+              handler_(std::move(other.handler_)) {}
+
+        PayloadEvent(const PayloadEvent &) = delete;
+        PayloadEvent &operator=(const PayloadEvent &) = delete;
+        PayloadEvent &operator=(PayloadEvent &&) = delete;
+
+        ~PayloadEvent() {
+            if (data_ != nullptr) {
+                arena_->deallocate(data_, size_, alignof(std::max_align_t));
+            }
+        }
+
+        void operator()() { handler_(std::span<const std::byte>(data_, size_)); }
+
+    private:
+        PayloadArena *arena_;
+        std::byte *data_;
+        std::size_t size_;
+        Handler handler_;
+    };
+
+    std::size_t ringCapacity() const;
+    void bindStorage(std::span<const std::byte> storage);
+    bool enqueue(Event &&event, Priority priority, OverflowPolicy policy);
+    bool pushToProducerLane(Producer::Lane &lane, Event &&event);
+    /**
+     * @brief Runs expired timers and then queued events (except Mutex batches) within @p limit.
+     *
+     * @return The number of timers run.
+     */
+    std::size_t drain(DrainMode mode, ProcessLimit &limit);
+    void processRing(DrainMode mode, ProcessLimit &limit);
+    void processProducerLanes(DrainMode mode, ProcessLimit &limit);
+    void processBatch();
+    /**
+     * @brief Runs up to @p budget events per lane by popping them one at a time under the lock.
+     *
+     * Used by a batch drain of a bounded queue while another batch drain holds the spare buffers.
+     */
+    void processBatchInPlace(std::array<std::size_t, kPriorityCount> budget);
+
+    /**
+     * @brief Runs a dequeued event, recording its queue wait and handler time if metrics are enabled.
+     */
+    void dispatch(Event &event, EnqueueStamp stamp);
+
+    /**
+     * @brief Inserts a timer and wakes a parked consumer so it can shorten its sleep.
+     */
+    TimerId addTimer(std::chrono::steady_clock::time_point when, Event &&event,
+                     std::chrono::nanoseconds period);
+
+    /**
+     * @brief Runs the events of every expired timer and re-arms the periodic ones.
+     *
+     * @return The number of timer events run.
+     */
+    std::size_t runDueTimers();
+
+    /**
+     * @brief Returns the number of queued events (approximate for the lock-free backends).
+     */
+    std::size_t pendingEvents() const;
+
+    /**
+     * @brief Returns when the next timer may expire, or time_point::max() if none is pending.
+     */
+    std::chrono::steady_clock::time_point nextTimerExpiry() const;
+
+    /**
+     * @brief Parks the caller until the queue is non-empty, a timer is due, or @p deadline passes.
+     *
+     * @return true if the queue is non-empty or a timer is due.
+     */
+    bool waitForWork(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Wakes a parked consumer after a push, skipping the notification if none is parked.
+     */
+    void notifyConsumer();
+
+    /**
+     * @brief Parks a producer under OverflowPolicy::Block until @p entry fits into @p ring.
+     *
+     * Used by the lock-free backends, whose rings have no mutex to wait on.
+     */
+    template <typename Ring, typename Entry>
+    void waitForRingSpace(Ring &ring, Entry &entry);
+
+    /**
+     * @brief Wakes producers parked in waitForRingSpace() after a pop, skipping the
+     *        notification if none is parked.
+     */
+    void notifyBlockedProducers();
+
+    Options options_;           ///< The configuration given at construction.
+    NumaMemoryResource payloadUpstream_; ///< Chunk source of payloadArena_ (bound to Options::numaNode).
+    // Declared before the lanes so that they outlive the queued events that refer to them.
+    PayloadArena payloadArena_; ///< Backs the payload copies of pushPayloadEvent().
+    std::mutex coalesceMutex_;  ///< Protects coalesced_.
+    std::unordered_map<std::uint64_t, Event> coalesced_; ///< Latest event per key with a pending dispatch.
+    Lanes lanes_;               ///< Pending events per priority lane (Mutex backend).
+    mutable std::mutex mutex_;  ///< Mutex to protect access to the event queue (Mutex backend).
+    Lanes spareBatch_;          ///< Recycled batch storage for DrainMode::Batch (guarded by mutex_).
+    LaneScheduler scheduler_;   ///< Lane selection for PerEvent drains (guarded by mutex_ or the consumer).
+    std::array<std::unique_ptr<MpscRingBuffer<QueuedEvent>>, kPriorityCount> rings_; ///< Lock-free storage per lane (LockFreeRing backend).
+
+    std::vector<std::unique_ptr<Producer::Lane>> producerLanes_; ///< Registered producers' rings (ShardedSpsc; sized once).
+    std::atomic<std::size_t> producerCount_{0}; ///< Number of entries of producerLanes_ in use.
+    std::mutex registerMutex_;                  ///< Serializes registerProducer().
+    std::size_t producerCursor_ = 0;            ///< Lane the next round-robin pass starts at (consumer only).
+    std::vector<std::size_t> producerBudget_;   ///< Per-lane drain budget (consumer only).
+    alignas(kCacheLineSize) std::atomic<std::uint64_t> nextSequence_{0}; ///< ProducerOrdering::GlobalSequence counter.
+
+    std::condition_variable notFullCv_; ///< Signalled when a drain frees space in a bounded lane.
+    int blockedProducers_ = 0;          ///< Producers waiting on notFullCv_ (guarded by mutex_).
+    std::atomic<std::uint64_t> droppedOldest_{0}; ///< See OverflowCounters::droppedOldest.
+    std::atomic<std::uint64_t> droppedNewest_{0}; ///< See OverflowCounters::droppedNewest.
+    std::atomic<std::uint64_t> rejected_{0};      ///< See OverflowCounters::rejected.
+    [[no_unique_address]] mutable QueueMetrics metrics_; ///< Instrumentation (empty unless enabled).
+
+    mutable std::mutex timerMutex_;          ///< Protects timers_.
+    Timers timers_;                          ///< Pending delayed and periodic events.
+    std::atomic<std::size_t> timerCount_{0}; ///< Mirror of timers_.size() for lock-free checks.
+
+    std::mutex waitMutex_;                ///< Protects the consumer's transition to sleep.
+    std::condition_variable waitCv_;      ///< Signalled when a push or new timer finds a parked consumer.
+    std::atomic<int> waitingConsumers_{0}; ///< Number of consumers parked in waitForWork().
+
+    std::mutex ringSpaceMutex_;                ///< Protects a producer's transition to sleep on a full ring.
+    std::condition_variable ringSpaceCv_;      ///< Signalled when a pop finds a parked producer.
+    std::atomic<int> blockedRingProducers_{0}; ///< Producers parked in waitForRingSpace().
+};
+
+/**
+ * @brief The ring of one registered producer, padded so that no two producers share a line.
+ */
+struct alignas(kCacheLineSize) EventQueue::Producer::Lane {
+    explicit Lane(std::size_t capacity) : ring(capacity) {}
+
+    SpscRingBuffer<SequencedEvent> ring; ///< Events pushed by this producer.
 };
 
 } // namespace event_queue
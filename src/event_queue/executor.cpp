@@ -0,0 +1,269 @@
+/**
+ * @file executor.cpp
+ * @brief Implementation of the Executor class.
+ *
+ * This file implements the work-stealing worker pool declared in executor.hpp. Each worker
+ * first drains its own queue, then tries to steal from the other workers, and finally parks
+ * on a condition variable until a submit or shutdown wakes it.
+ */
+
+#include "executor.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "logger.hpp"
+#include "thread_affinity.hpp"
+
+namespace event_queue {
+
+namespace {
+
+/**
+ * @brief The executor and worker index of the calling thread, if it is a worker.
+ */
+thread_local const void *currentExecutor = nullptr;
+thread_local std::size_t currentWorkerIndex = 0;
+
+} // namespace
+
+std::size_t Executor::defaultWorkerCount() {
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+Executor::Executor(std::size_t workerCount)
+    : Executor([&]() {
+          Options options;
+          options.workerCount = workerCount;
+          return options;
+      }()) {
+}
+
+Executor::Executor(const Options &options)
+    : options_(options), started_(static_cast<std::ptrdiff_t>(std::max<std::size_t>(options.workerCount, 1))) {
+    const std::size_t workerCount = std::max<std::size_t>(options_.workerCount, 1);
+    workers_.reserve(workerCount);
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Start the threads only once every worker exists, since they steal from each other.
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+    started_.wait();
+    if (!options_.cpus.empty()) {
+        common::Logger::info("Executor: " + CpuTopology::system().describe());
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            const WorkerPlacement &placement = workers_[i]->placement;
+            if (placement.cpu >= 0) {
+                common::Logger::info("Executor: worker " + std::to_string(i) + " pinned to CPU " +
+                                     std::to_string(placement.cpu) + " (NUMA node " +
+                                     std::to_string(placement.node) + ")");
+            }
+        }
+    }
+}
+
+Executor::~Executor() {
+    shutdown(ShutdownMode::Drain);
+}
+
+bool Executor::submit(Event &&event) {
+    const bool fromWorker = currentExecutor == this;
+    if (!fromWorker && !accepting_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    // Handlers keep their follow-up work local; external submits are spread round-robin.
+    const std::size_t index =
+        fromWorker ? currentWorkerIndex : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        Worker &worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        // Check again under the lock: shutdown() passes through every worker's lock after it
+        // stops accepting, so either it waits for this push or this submit sees the flag.
+        if (!fromWorker && !accepting_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        worker.events.push(std::move(event));
+        worker.queued.store(worker.events.size(), std::memory_order_relaxed);
+    }
+    wakeIdleWorker();
+    return true;
+}
+
+void Executor::shutdown(ShutdownMode mode) {
+    std::lock_guard<std::mutex> shutdownLock(shutdownMutex_);
+    accepting_.store(false, std::memory_order_release);
+    // Let external submits that passed the check finish their push, so that the workers see
+    // the event before they can find the pool drained.
+    for (auto &worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        if (stopping_.load()) {
+            return;
+        }
+        stopping_.store(true);
+        discard_.store(mode == ShutdownMode::Discard, std::memory_order_release);
+    }
+    idleCv_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::size_t Executor::workerCount() const {
+    return workers_.size();
+}
+
+std::vector<Executor::WorkerPlacement> Executor::placement() const {
+    std::vector<WorkerPlacement> result;
+    result.reserve(workers_.size());
+    for (const auto &worker : workers_) {
+        result.push_back(worker->placement);
+    }
+    return result;
+}
+
+void Executor::placeWorker(std::size_t index) {
+    Worker &worker = *workers_[index];
+    if (!options_.cpus.empty()) {
+        const unsigned cpu = options_.cpus[index % options_.cpus.size()];
+        if (pinCurrentThread(cpu)) {
+            worker.placement.cpu = static_cast<int>(cpu);
+            worker.placement.node = CpuTopology::system().nodeOf(cpu);
+            // Allocate the queue from the pinned thread and keep it on the worker's node.
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.events.reserve(options_.pinnedQueueCapacity);
+            const auto storage = worker.events.storage();
+            bindToNumaNode(storage.data(), storage.size(), worker.placement.node);
+        } else {
+            common::Logger::warning("Executor: cannot pin worker " + std::to_string(index) + " to CPU " +
+                                    std::to_string(cpu) + "; it runs unpinned");
+        }
+    }
+    started_.count_down();
+}
+
+void Executor::workerLoop(std::size_t index) {
+    currentExecutor = this;
+    currentWorkerIndex = index;
+    placeWorker(index);
+    while (true) {
+        if (discard_.load(std::memory_order_acquire)) {
+            // Drop whatever is still queued on this worker, then leave. The events are destroyed
+            // after the lock is released: their destructors may submit or take other locks.
+            Worker &worker = *workers_[index];
+            CircularBuffer<Event> dropped;
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                dropped.swap(worker.events);
+                worker.queued.store(0, std::memory_order_relaxed);
+            }
+            break;
+        }
+
+        // The counters are per worker and written only by plain stores, so taking and running an
+        // event touches no cache line shared by all workers. The worker marks itself running
+        // before it takes an event (the release store of the queue's count orders the two), so
+        // drained(), which reads the counts before the flags, never sees it idle with an event
+        // in hand; the totals are only summed once shutdown has begun.
+        Worker &self = *workers_[index];
+        self.running.store(true, std::memory_order_relaxed);
+        Event event;
+        if (tryTakeOwn(index, event) || trySteal(index, event)) {
+            if (event) {
+                event();
+            }
+            self.running.store(false, std::memory_order_release);
+            if (stopping_.load(std::memory_order_relaxed) && drained()) {
+                // The pool may have just become idle during shutdown: let parked workers exit.
+                std::lock_guard<std::mutex> lock(idleMutex_);
+                idleCv_.notify_all();
+            }
+            continue;
+        }
+        self.running.store(false, std::memory_order_release);
+
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        // Announce the sleeper before re-checking for work (paired with wakeIdleWorker()).
+        idleWorkers_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        idleCv_.wait(lock, [this]() { return hasQueuedEvents() || drained(); });
+        idleWorkers_.fetch_sub(1, std::memory_order_relaxed);
+        if (drained() && !discard_.load()) {
+            // Another worker may have parked while this one briefly showed as running.
+            idleCv_.notify_all();
+            break;
+        }
+    }
+    currentExecutor = nullptr;
+}
+
+bool Executor::hasQueuedEvents() const {
+    for (const auto &worker : workers_) {
+        if (worker->queued.load(std::memory_order_acquire) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Executor::drained() const {
+    if (!stopping_.load() || hasQueuedEvents()) {
+        return false;
+    }
+    for (const auto &worker : workers_) {
+        if (worker->running.load(std::memory_order_acquire)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Executor::tryTakeOwn(std::size_t index, Event &event) {
+    Worker &worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.events.empty()) {
+        return false;
+    }
+    event = std::move(worker.events.front());
+    worker.events.pop();
+    worker.queued.store(worker.events.size(), std::memory_order_release);
+    return true;
+}
+
+bool Executor::trySteal(std::size_t thief, Event &event) {
+    const std::size_t count = workers_.size();
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        Worker &victim = *workers_[(thief + offset) % count];
+        // Skip victims whose lock is busy rather than queueing up behind them.
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.events.empty()) {
+            continue;
+        }
+        event = std::move(victim.events.front());
+        victim.events.pop();
+        victim.queued.store(victim.events.size(), std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+void Executor::wakeIdleWorker() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // Skip the notification when every worker is already busy.
+    if (idleWorkers_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+    }
+    idleCv_.notify_one();
+}
+
+} // namespace event_queue
@@ -0,0 +1,183 @@
+#ifndef EXECUTOR_HPP
+#define EXECUTOR_HPP
+
+/**
+ * @file executor.hpp
+ * @brief Declaration of the Executor class, a work-stealing thread pool for events.
+ *
+ * An EventQueue is drained by whichever thread calls processEvents(), so all handlers run on
+ * one core. The Executor owns a fixed set of worker threads instead. Every worker has its own
+ * queue of events; a worker that runs out of work steals from the others, so CPU-bound
+ * handlers spread across all workers without funnelling through a single lock.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "circular_buffer.hpp"
+#include "event_queue.hpp"
+
+namespace event_queue {
+
+/**
+ * @brief A pool of worker threads that run events with work stealing.
+ *
+ * Events submitted from outside the pool are distributed round-robin over the workers' queues;
+ * events submitted by a running handler go to the queue of the worker that runs it. Idle
+ * workers first try to steal from the other workers and then park on a condition variable, so
+ * an idle executor does not consume CPU.
+ *
+ * Events may run concurrently and in any order. Use an EventQueue when ordering matters.
+ */
+class Executor {
+public:
+    /**
+     * @brief Type alias for the unit of work; the same callable type as EventQueue::Event.
+     */
+    using Event = EventQueue::Event;
+
+    /**
+     * @brief Selects what happens to queued events when the executor shuts down.
+     */
+    enum class ShutdownMode {
+        Drain,  ///< Run every event already submitted (and those they submit) before stopping.
+        Discard ///< Destroy queued events without running them; running handlers still finish.
+    };
+
+    /**
+     * @brief Returns the default number of workers: one per hardware thread (at least one).
+     */
+    static std::size_t defaultWorkerCount();
+
+    /**
+     * @brief Construction-time configuration of an Executor.
+     */
+    struct Options {
+        /// The number of workers to start. Zero is treated as one.
+        std::size_t workerCount = defaultWorkerCount();
+        /// CPUs to pin the workers to: worker i runs on cpus[i % cpus.size()]. Empty leaves
+        /// placement to the scheduler.
+        std::vector<unsigned> cpus;
+        /// Events a pinned worker's queue holds before it grows. The worker allocates this
+        /// storage itself, bound to its CPU's NUMA node.
+        std::size_t pinnedQueueCapacity = 1024;
+    };
+
+    /**
+     * @brief Where a worker runs, as reported by placement().
+     */
+    struct WorkerPlacement {
+        int cpu = -1;  ///< The CPU the worker is pinned to, or -1 if it is not pinned.
+        int node = -1; ///< The NUMA node of that CPU, or -1.
+    };
+
+    /**
+     * @brief Starts an executor with @p workerCount worker threads.
+     *
+     * @param workerCount The number of workers to start. Zero is treated as one.
+     */
+    explicit Executor(std::size_t workerCount = defaultWorkerCount());
+
+    /**
+     * @brief Starts an executor with the given options.
+     *
+     * If Options::cpus is set, every worker pins itself before it takes any work, and the
+     * constructor logs the machine topology and each worker's CPU and node (through
+     * common::Logger) once all workers are placed. A worker that cannot be pinned logs a
+     * warning and runs unpinned.
+     */
+    explicit Executor(const Options &options);
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief Shuts the executor down with ShutdownMode::Drain if it is still running.
+     */
+    ~Executor();
+
+    /**
+     * @brief Submits an event for execution on one of the workers.
+     *
+     * @param event The event to run. It is moved into the executor.
+     * @return true if the event was accepted, false if the executor has been shut down.
+     */
+    bool submit(Event &&event);
+
+    /**
+     * @brief Submits any callable as an event.
+     *
+     * @param callable The callable to run.
+     * @return true if the event was accepted, false if the executor has been shut down.
+     */
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, Event> && std::is_constructible_v<Event, F>)
+    bool submit(F &&callable) {
+        return submit(Event(std::forward<F>(callable)));
+    }
+
+    /**
+     * @brief Stops accepting events and joins the worker threads.
+     *
+     * Must not be called from one of the executor's own workers. Calling it again has no effect.
+     *
+     * @param mode Whether pending events are run or discarded.
+     */
+    void shutdown(ShutdownMode mode = ShutdownMode::Drain);
+
+    /**
+     * @brief Returns the number of worker threads.
+     */
+    std::size_t workerCount() const;
+
+    /**
+     * @brief Returns where each worker runs, indexed by worker.
+     */
+    std::vector<WorkerPlacement> placement() const;
+
+private:
+    /**
+     * @brief Per-worker state, aligned to keep workers' locks on separate cache lines.
+     */
+    struct alignas(kCacheLineSize) Worker {
+        std::mutex mutex;                  ///< Protects events.
+        CircularBuffer<Event> events;      ///< The worker's own queue; other workers steal from it.
+        std::atomic<std::size_t> queued{0}; ///< Mirror of events.size(), stored under mutex.
+        std::atomic<bool> running{false};  ///< True while the worker takes or runs an event (worker only).
+        std::thread thread;                ///< The worker thread.
+        WorkerPlacement placement;         ///< Set by the worker before it counts down started_.
+    };
+
+    void placeWorker(std::size_t index);
+    void workerLoop(std::size_t index);
+    bool tryTakeOwn(std::size_t index, Event &event);
+    bool trySteal(std::size_t thief, Event &event);
+    void wakeIdleWorker();
+    bool hasQueuedEvents() const;
+    bool drained() const;
+
+    Options options_;                              ///< The configuration given at construction.
+    std::vector<std::unique_ptr<Worker>> workers_; ///< The workers (fixed after construction).
+    std::latch started_;                           ///< Counts workers that have not placed themselves yet.
+    std::atomic<std::size_t> nextWorker_{0};       ///< Round-robin cursor for external submits.
+
+    std::mutex idleMutex_;              ///< Protects parking and changes to the shutdown flags.
+    std::condition_variable idleCv_;    ///< Signalled when work arrives or on shutdown.
+    std::atomic<int> idleWorkers_{0};   ///< Number of parked workers.
+    std::atomic<bool> accepting_{true}; ///< False once shutdown() has been called.
+    std::atomic<bool> stopping_{false}; ///< Set by shutdown(); workers exit once drained().
+    std::atomic<bool> discard_{false};  ///< Workers drop queued events instead of running them.
+    std::mutex shutdownMutex_;          ///< Serializes concurrent shutdown() calls.
+};
+
+} // namespace event_queue
+
+#endif // EXECUTOR_HPP
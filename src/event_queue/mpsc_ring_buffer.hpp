@@ -0,0 +1,192 @@
+#ifndef MPSC_RING_BUFFER_HPP
+#define MPSC_RING_BUFFER_HPP
+
+/**
+ * @file mpsc_ring_buffer.hpp
+ * @brief Declaration of a bounded lock-free multi-producer/single-consumer ring buffer.
+ *
+ * This file declares the MpscRingBuffer class template, which is used by EventQueue as an
+ * alternative to the mutex-protected std::queue. Producers claim slots with a single
+ * compare-and-swap on the tail index and publish them through a per-slot sequence number,
+ * so pushes from different threads never serialize on a lock.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace event_queue {
+
+/**
+ * @brief Size used to keep independently written indices on separate cache lines.
+ */
+inline constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * @brief A bounded lock-free ring buffer for many producers and one consumer.
+ *
+ * The implementation follows the classic sequence-numbered cell design: every cell carries
+ * an atomic sequence number that tells producers whether the cell is free for the current
+ * lap and tells the consumer whether the value in it has been published. The capacity is
+ * rounded up to the next power of two.
+ *
+ * tryPush() may be called concurrently from any number of threads. tryPop() must only ever
+ * be called from a single consumer thread at a time.
+ *
+ * @tparam T The element type. It must be move-constructible.
+ */
+template <typename T>
+class MpscRingBuffer {
+public:
+    /**
+     * @brief Constructs a ring buffer able to hold at least @p capacity elements.
+     *
+     * @param capacity The requested capacity. It is rounded up to a power of two (minimum 2).
+     */
+    explicit MpscRingBuffer(std::size_t capacity)
+        : capacity_(roundUpToPowerOfTwo(capacity)),
+          mask_(capacity_ - 1),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer &) = delete;
+    MpscRingBuffer &operator=(const MpscRingBuffer &) = delete;
+
+    /**
+     * @brief Destroys any elements that were pushed but never popped.
+     */
+    ~MpscRingBuffer() {
+        for (std::size_t pos = head_.load(std::memory_order_relaxed);; ++pos) {
+            Cell &cell = cells_[pos & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            std::launder(reinterpret_cast<T *>(cell.storage()))->~T();
+        }
+    }
+
+    /**
+     * @brief Attempts to append an element.
+     *
+     * @param value The element to move into the buffer.
+     * @return true if the element was stored, false if the buffer was full.
+     */
+    bool tryPush(T &&value) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = cells_[pos & mask_];
+            const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // The cell is free for this lap; try to claim it.
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (cell.storage()) T(std::move(value));
+                    // Publish the value to the consumer.
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // The consumer has not released this cell yet: the buffer is full.
+                return false;
+            } else {
+                // Another producer claimed the cell first; reload the tail and retry.
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Attempts to remove the oldest published element.
+     *
+     * Must only be called from the single consumer thread.
+     *
+     * @param out Receives the element on success.
+     * @return true if an element was removed, false if no published element was available.
+     */
+    bool tryPop(T &out) {
+        const std::size_t pos = head_.load(std::memory_order_relaxed);
+        Cell &cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        T *value = std::launder(reinterpret_cast<T *>(cell.storage()));
+        out = std::move(*value);
+        value->~T();
+        // Hand the cell back to producers for the next lap.
+        cell.sequence.store(pos + capacity_, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether a published element is available to the consumer.
+     *
+     * The answer is only a snapshot when producers are pushing concurrently. A slot that has
+     * been claimed but not yet published is reported as empty.
+     *
+     * @return true if the next element to pop has not been published.
+     */
+    bool empty() const {
+        const std::size_t pos = head_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    /**
+     * @brief Returns an approximate number of elements in the buffer.
+     *
+     * Slots claimed by producers that have not finished publishing are included.
+     */
+    std::size_t sizeApprox() const {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Returns the actual (power-of-two) capacity of the buffer.
+     */
+    std::size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Returns the bytes of the slot array (e.g. to place it with bindToNumaNode()).
+     */
+    std::span<const std::byte> storage() const {
+        return std::as_bytes(std::span(cells_.get(), capacity_));
+    }
+
+private:
+    /**
+     * @brief A single slot with its sequence number and uninitialized storage for a T.
+     */
+    struct Cell {
+        std::atomic<std::size_t> sequence{0}; ///< Lap-aware state of the slot.
+        alignas(T) unsigned char bytes[sizeof(T)]; ///< Raw storage for the element.
+
+        void *storage() { return bytes; }
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t capacity_;     ///< Number of cells (a power of two).
+    const std::size_t mask_;         ///< capacity_ - 1, used to map indices to cells.
+    std::unique_ptr<Cell[]> cells_;  ///< The cell array.
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0}; ///< Next position producers claim.
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0}; ///< Next position the consumer reads.
+};
+
+} // namespace event_queue
+
+#endif // MPSC_RING_BUFFER_HPP
@@ -0,0 +1,184 @@
+/**
+ * @file payload_arena.cpp
+ * @brief Implementation of the PayloadArena class.
+ *
+ * Chunks are allocated with kChunkSize alignment, so the chunk header of any small allocation
+ * is found by masking the pointer. Each header counts the live allocations and bytes in its
+ * chunk, packed into one atomic word so that a deallocation is a single atomic subtraction; the
+ * deallocation that brings the count to zero puts the chunk back on the free list (or, for the
+ * chunk currently being filled, rewinds its bump pointer). stats() sums the chunk counters.
+ */
+
+#include "payload_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace event_queue {
+
+/**
+ * @brief Header stored at the start of every chunk.
+ */
+struct PayloadArena::Chunk {
+    std::atomic<std::uint64_t> live{0}; ///< Live allocations (high 32 bits) and bytes (low 32 bits).
+    std::size_t used = 0;             ///< Bump offset from the start of the chunk (guarded by mutex_).
+    Chunk *nextFree = nullptr;        ///< Next chunk on the free list.
+    Chunk *nextAll = nullptr;         ///< Next chunk in the list of all chunks.
+    bool isFree = false;              ///< Whether the chunk is on the free list.
+};
+
+namespace {
+
+/// Unit of the allocation count in Chunk::live.
+constexpr std::uint64_t kOneAllocation = std::uint64_t{1} << 32;
+
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Whether an allocation bypasses the chunks and goes to the upstream resource.
+ */
+constexpr bool isLarge(std::size_t bytes, std::size_t alignment) {
+    return bytes > PayloadArena::kMaxSmallAllocation || alignment > PayloadArena::kMaxSmallAllocation;
+}
+
+} // namespace
+
+const std::size_t PayloadArena::kHeaderSize = alignUp(sizeof(Chunk), alignof(std::max_align_t));
+
+double PayloadArena::Stats::fragmentation() const {
+    const std::size_t inUse = chunks - freeChunks;
+    if (inUse == 0) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(liveBytes) / static_cast<double>(inUse * kChunkSize);
+}
+
+PayloadArena::PayloadArena(std::pmr::memory_resource *upstream) : upstream_(upstream) {
+}
+
+PayloadArena::~PayloadArena() {
+    for (Chunk *chunk = allChunks_; chunk != nullptr;) {
+        Chunk *next = chunk->nextAll;
+        chunk->~Chunk();
+        upstream_->deallocate(chunk, kChunkSize, kChunkSize);
+        chunk = next;
+    }
+}
+
+PayloadArena::Stats PayloadArena::stats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.chunks = chunkCount_;
+        stats.freeChunks = freeCount_;
+        for (const Chunk *chunk = allChunks_; chunk != nullptr; chunk = chunk->nextAll) {
+            const std::uint64_t live = chunk->live.load(std::memory_order_relaxed);
+            stats.liveAllocations += static_cast<std::size_t>(live / kOneAllocation);
+            stats.liveBytes += static_cast<std::size_t>(live % kOneAllocation);
+        }
+    }
+    stats.liveAllocations += liveUpstream_.load(std::memory_order_relaxed);
+    stats.reservedBytes = stats.chunks * kChunkSize;
+    stats.upstreamAllocations = upstreamAllocations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PayloadArena::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_ != nullptr && current_->live.load(std::memory_order_acquire) == 0) {
+        recycle(current_);
+        current_ = nullptr;
+    }
+    Chunk **link = &allChunks_;
+    while (*link != nullptr) {
+        Chunk *chunk = *link;
+        if (chunk->isFree) {
+            *link = chunk->nextAll;
+            chunk->~Chunk();
+            upstream_->deallocate(chunk, kChunkSize, kChunkSize);
+            --chunkCount_;
+        } else {
+            link = &chunk->nextAll;
+        }
+    }
+    freeList_ = nullptr;
+    freeCount_ = 0;
+}
+
+void *PayloadArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (isLarge(bytes, alignment)) {
+        upstreamAllocations_.fetch_add(1, std::memory_order_relaxed);
+        liveUpstream_.fetch_add(1, std::memory_order_relaxed);
+        return upstream_->allocate(bytes, alignment);
+    }
+    bytes = std::max<std::size_t>(bytes, 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_ == nullptr || alignUp(current_->used, alignment) + bytes > kChunkSize) {
+        Chunk *previous = current_;
+        current_ = takeChunk();
+        if (previous != nullptr && previous->live.load(std::memory_order_acquire) == 0) {
+            recycle(previous);
+        }
+    }
+    const std::size_t offset = alignUp(current_->used, alignment);
+    current_->used = offset + bytes;
+    current_->live.fetch_add(kOneAllocation + bytes, std::memory_order_relaxed);
+    return reinterpret_cast<unsigned char *>(current_) + offset;
+}
+
+void PayloadArena::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+    if (isLarge(bytes, alignment)) {
+        liveUpstream_.fetch_sub(1, std::memory_order_relaxed);
+        upstream_->deallocate(p, bytes, alignment);
+        return;
+    }
+    const std::uint64_t released = kOneAllocation + std::max<std::size_t>(bytes, 1);
+    auto *chunk = reinterpret_cast<Chunk *>(reinterpret_cast<std::uintptr_t>(p) & ~(kChunkSize - 1));
+    if (chunk->live.fetch_sub(released, std::memory_order_acq_rel) != released) {
+        return;
+    }
+    // Last live allocation of the chunk: reclaim all of it at once. Re-check under the lock,
+    // since an allocation may have reused the chunk in the meantime.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (chunk->live.load(std::memory_order_acquire) != 0 || chunk->isFree) {
+        return;
+    }
+    if (chunk == current_) {
+        chunk->used = kHeaderSize;
+    } else {
+        recycle(chunk);
+    }
+}
+
+bool PayloadArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+PayloadArena::Chunk *PayloadArena::takeChunk() {
+    if (freeList_ != nullptr) {
+        Chunk *chunk = freeList_;
+        freeList_ = chunk->nextFree;
+        chunk->isFree = false;
+        --freeCount_;
+        return chunk;
+    }
+    auto *chunk = ::new (upstream_->allocate(kChunkSize, kChunkSize)) Chunk();
+    chunk->used = kHeaderSize;
+    chunk->nextAll = allChunks_;
+    allChunks_ = chunk;
+    ++chunkCount_;
+    return chunk;
+}
+
+void PayloadArena::recycle(Chunk *chunk) {
+    chunk->used = kHeaderSize;
+    chunk->isFree = true;
+    chunk->nextFree = freeList_;
+    freeList_ = chunk;
+    ++freeCount_;
+}
+
+} // namespace event_queue
@@ -0,0 +1,112 @@
+#ifndef PAYLOAD_ARENA_HPP
+#define PAYLOAD_ARENA_HPP
+
+/**
+ * @file payload_arena.hpp
+ * @brief Declaration of PayloadArena, a chunked bump allocator for event payloads.
+ *
+ * Events that carry buffers or strings allocate when they are pushed and free when they have
+ * run. PayloadArena serves those allocations from large chunks with a bump pointer and only
+ * counts frees: once every allocation of a chunk has been freed (typically when the drained
+ * batch that used it completes), the whole chunk is reclaimed at once and reused. Allocation
+ * is a pointer increment under a short lock and deallocation is an atomic decrement.
+ *
+ * The arena is a std::pmr::memory_resource, so it can back std::pmr containers captured by
+ * events as well as EventQueue::pushPayloadEvent().
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace event_queue {
+
+/**
+ * @brief A thread-safe chunked arena that reclaims memory a whole chunk at a time.
+ *
+ * Allocations of up to kMaxSmallAllocation bytes are carved out of kChunkSize-byte chunks.
+ * Larger ones are forwarded to the upstream resource. A chunk stays reserved as long as any
+ * allocation in it is live, so one long-lived payload pins its chunk; stats() reports how much
+ * reserved memory is live, to keep such fragmentation visible.
+ */
+class PayloadArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Size (and alignment) of each chunk.
+     */
+    static constexpr std::size_t kChunkSize = std::size_t{64} * 1024;
+
+    /**
+     * @brief Largest allocation served from a chunk; larger ones go to the upstream resource.
+     */
+    static constexpr std::size_t kMaxSmallAllocation = kChunkSize / 4;
+
+    /**
+     * @brief A snapshot of the arena's memory use.
+     */
+    struct Stats {
+        std::size_t chunks = 0;               ///< Chunks allocated from upstream.
+        std::size_t freeChunks = 0;           ///< Chunks waiting on the free list for reuse.
+        std::size_t liveAllocations = 0;      ///< Allocations not yet deallocated (chunks and upstream).
+        std::size_t liveBytes = 0;            ///< Bytes in live chunk allocations.
+        std::size_t reservedBytes = 0;        ///< Bytes held in chunks (chunks * kChunkSize).
+        std::size_t upstreamAllocations = 0;  ///< Total allocations forwarded to upstream.
+
+        /**
+         * @brief Fraction of the chunks in use that does not hold live data (0 when none are in use).
+         */
+        double fragmentation() const;
+    };
+
+    /**
+     * @brief Constructs an empty arena. No chunk is allocated until the first allocation.
+     *
+     * @param upstream The resource used for chunks and for large allocations.
+     */
+    explicit PayloadArena(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+
+    PayloadArena(const PayloadArena &) = delete;
+    PayloadArena &operator=(const PayloadArena &) = delete;
+
+    /**
+     * @brief Returns every chunk to upstream. All allocations must have been freed.
+     */
+    ~PayloadArena() override;
+
+    /**
+     * @brief Returns a snapshot of the arena's memory use.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Returns every chunk without live allocations to the upstream resource.
+     */
+    void trim();
+
+private:
+    struct Chunk;
+
+    static const std::size_t kHeaderSize; ///< Bytes reserved for the Chunk header at the start of a chunk.
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    Chunk *takeChunk();
+    void recycle(Chunk *chunk);
+
+    std::pmr::memory_resource *upstream_; ///< Source of chunks and large allocations.
+    mutable std::mutex mutex_;            ///< Protects the chunk lists and current_.
+    Chunk *current_ = nullptr;            ///< The chunk new allocations are carved from.
+    Chunk *freeList_ = nullptr;           ///< Reclaimed chunks ready for reuse.
+    Chunk *allChunks_ = nullptr;          ///< Every chunk, for destruction.
+    std::size_t chunkCount_ = 0;          ///< Number of chunks allocated from upstream.
+    std::size_t freeCount_ = 0;           ///< Number of chunks on freeList_.
+    std::atomic<std::size_t> liveUpstream_{0};        ///< Live allocations forwarded to upstream.
+    std::atomic<std::size_t> upstreamAllocations_{0}; ///< See Stats::upstreamAllocations.
+};
+
+} // namespace event_queue
+
+#endif // PAYLOAD_ARENA_HPP
@@ -0,0 +1,351 @@
+#ifndef QUEUE_METRICS_HPP
+#define QUEUE_METRICS_HPP
+
+/**
+ * @file queue_metrics.hpp
+ * @brief Declaration of the optional EventQueue instrumentation.
+ *
+ * When EVENT_QUEUE_ENABLE_METRICS is non-zero, every EventQueue counts the events pushed and
+ * removed, tracks its depth and high-water mark, and records two log-linear (HDR-style)
+ * histograms: the time from push to the start of dispatch, and the time spent in the handler.
+ * Counters live in cache-line-sized shards picked per thread, so recording is a relaxed atomic
+ * increment on a line no other thread writes; EventQueue::metrics() merges the shards.
+ *
+ * When the macro is zero (the default), QueueMetrics and EnqueueStamp are empty classes whose
+ * member functions do nothing, so the instrumentation compiles away entirely.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "mpsc_ring_buffer.hpp"
+
+/**
+ * @brief Compiles the EventQueue instrumentation in (1) or out (0).
+ *
+ * Set it with the EVENT_QUEUE_ENABLE_METRICS CMake option, or define it before including
+ * event_queue.hpp. Every translation unit of a program must use the same value.
+ */
+#ifndef EVENT_QUEUE_ENABLE_METRICS
+#define EVENT_QUEUE_ENABLE_METRICS 0
+#endif
+
+namespace event_queue {
+
+/**
+ * @brief A merged snapshot of a log-linear latency histogram.
+ *
+ * Each power of two is split into kSubBuckets linear buckets, so a recorded value is known to
+ * within 1/kSubBuckets (12.5%) of itself, from nanoseconds up to about 18 minutes.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr std::uint64_t kSubBuckets = std::uint64_t{1} << kSubBucketBits;
+    /// Values at or above 2^kMaxBits nanoseconds are recorded in the last bucket.
+    static constexpr unsigned kMaxBits = 40;
+    static constexpr std::size_t kBucketCount = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+    /**
+     * @brief Returns the bucket that counts @p nanoseconds.
+     */
+    static constexpr std::size_t bucketFor(std::uint64_t nanoseconds) {
+        if (nanoseconds < kSubBuckets) {
+            return static_cast<std::size_t>(nanoseconds);
+        }
+        if (nanoseconds >= (std::uint64_t{1} << kMaxBits)) {
+            return kBucketCount - 1;
+        }
+        const unsigned shift = static_cast<unsigned>(std::bit_width(nanoseconds)) - 1 - kSubBucketBits;
+        return static_cast<std::size_t>((shift + 1) * kSubBuckets + ((nanoseconds >> shift) - kSubBuckets));
+    }
+
+    /**
+     * @brief Returns the smallest value counted by @p bucket, in nanoseconds.
+     */
+    static constexpr std::uint64_t lowerBound(std::size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const std::size_t shift = bucket / kSubBuckets - 1;
+        return (kSubBuckets + bucket % kSubBuckets) << shift;
+    }
+
+    /**
+     * @brief Returns the largest value counted by @p bucket, in nanoseconds.
+     */
+    static constexpr std::uint64_t upperBound(std::size_t bucket) {
+        return bucket + 1 < kBucketCount ? lowerBound(bucket + 1) - 1 : UINT64_MAX;
+    }
+
+    /**
+     * @brief Returns the number of recorded values.
+     */
+    std::uint64_t count() const { return count_; }
+
+    /**
+     * @brief Returns the mean of the recorded values (zero if none).
+     */
+    std::chrono::nanoseconds mean() const {
+        return std::chrono::nanoseconds(count_ == 0 ? 0 : static_cast<std::int64_t>(total_ / count_));
+    }
+
+    /**
+     * @brief Returns an upper bound of the @p quantile (0..1) of the recorded values.
+     *
+     * The result is the upper bound of the bucket holding the quantile, so it overestimates by
+     * at most 12.5%. Returns zero if nothing was recorded.
+     */
+    std::chrono::nanoseconds percentile(double quantile) const {
+        if (count_ == 0) {
+            return std::chrono::nanoseconds::zero();
+        }
+        const auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+            seen += buckets_[bucket];
+            if (seen >= rank) {
+                return std::chrono::nanoseconds(static_cast<std::int64_t>(std::min<std::uint64_t>(
+                    upperBound(bucket), static_cast<std::uint64_t>(INT64_MAX))));
+            }
+        }
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(lowerBound(kBucketCount - 1)));
+    }
+
+    /**
+     * @brief Returns the number of values counted by @p bucket.
+     */
+    std::uint64_t bucketCount(std::size_t bucket) const { return buckets_[bucket]; }
+
+    /**
+     * @brief Adds @p count values to @p bucket (used when merging).
+     */
+    void add(std::size_t bucket, std::uint64_t count) {
+        buckets_[bucket] += count;
+        count_ += count;
+    }
+
+    /**
+     * @brief Adds @p nanoseconds to the sum used by mean() (used when merging).
+     */
+    void addTotal(std::uint64_t nanoseconds) { total_ += nanoseconds; }
+
+private:
+    std::array<std::uint64_t, kBucketCount> buckets_{}; ///< Values per bucket.
+    std::uint64_t count_ = 0;                           ///< Sum of buckets_.
+    std::uint64_t total_ = 0;                           ///< Sum of the recorded values, in nanoseconds.
+};
+
+/**
+ * @brief A snapshot of an EventQueue's metrics, as returned by EventQueue::metrics().
+ */
+struct QueueMetricsSnapshot {
+    std::uint64_t enqueued = 0;     ///< Events accepted by the queue.
+    std::uint64_t dispatched = 0;   ///< Queued events that have started running.
+    std::uint64_t dropped = 0;      ///< Queued events evicted without running.
+    std::size_t depth = 0;          ///< Events queued at the time of the snapshot.
+    std::size_t highWaterMark = 0;  ///< Largest depth seen at the start of a drain or a snapshot.
+    LatencyHistogram queueWait;     ///< Time from push to the start of dispatch.
+    LatencyHistogram handlerTime;   ///< Time spent running handlers (including timers).
+};
+
+#if EVENT_QUEUE_ENABLE_METRICS
+
+/**
+ * @brief The time an event was pushed, carried with it through the queue.
+ */
+class EnqueueStamp {
+public:
+    static EnqueueStamp now() { return EnqueueStamp(std::chrono::steady_clock::now()); }
+
+    EnqueueStamp() = default;
+
+    std::chrono::steady_clock::time_point time() const { return time_; }
+
+private:
+    explicit EnqueueStamp(std::chrono::steady_clock::time_point time) : time_(time) {}
+
+    std::chrono::steady_clock::time_point time_;
+};
+
+/**
+ * @brief Sharded counters and histograms recorded by one EventQueue.
+ */
+class QueueMetrics {
+public:
+    /**
+     * @brief Counts an event accepted by the queue.
+     */
+    void recordEnqueue() { shard().enqueued.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Counts a queued event that was evicted without running.
+     */
+    void recordDrop() { shard().dropped.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Runs a queued event, recording its queue wait and handler time.
+     *
+     * @param stamp When the event was pushed.
+     * @param run Runs the event's handler.
+     */
+    template <typename F>
+    void dispatch(EnqueueStamp stamp, F &&run) {
+        Shard &counters = shard();
+        counters.dispatched.fetch_add(1, std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        record(counters.queueWait, start - stamp.time());
+        std::forward<F>(run)();
+        record(counters.handlerTime, std::chrono::steady_clock::now() - start);
+    }
+
+    /**
+     * @brief Runs a handler that did not go through the queue (a timer), recording its time.
+     */
+    template <typename F>
+    void time(F &&run) {
+        const auto start = std::chrono::steady_clock::now();
+        std::forward<F>(run)();
+        record(shard().handlerTime, std::chrono::steady_clock::now() - start);
+    }
+
+    /**
+     * @brief Raises the high-water mark to the current depth if needed.
+     */
+    void sampleDepth() {
+        const std::size_t current = depth();
+        std::size_t mark = highWaterMark_.load(std::memory_order_relaxed);
+        while (current > mark && !highWaterMark_.compare_exchange_weak(mark, current, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Merges every shard into a snapshot.
+     */
+    QueueMetricsSnapshot snapshot() {
+        sampleDepth();
+        QueueMetricsSnapshot result;
+        for (const Shard &counters : shards_) {
+            result.enqueued += counters.enqueued.load(std::memory_order_relaxed);
+            result.dispatched += counters.dispatched.load(std::memory_order_relaxed);
+            result.dropped += counters.dropped.load(std::memory_order_relaxed);
+            merge(result.queueWait, counters.queueWait);
+            merge(result.handlerTime, counters.handlerTime);
+        }
+        const std::uint64_t removed = result.dispatched + result.dropped;
+        result.depth = result.enqueued > removed ? static_cast<std::size_t>(result.enqueued - removed) : 0;
+        result.highWaterMark = std::max(highWaterMark_.load(std::memory_order_relaxed), result.depth);
+        return result;
+    }
+
+private:
+    /// Number of shards; threads beyond this share shards (still correctly, just contended).
+    static constexpr std::size_t kShardCount = 8;
+
+    /**
+     * @brief Per-thread histogram counters.
+     */
+    struct HistogramCounters {
+        std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBucketCount> buckets{};
+        std::atomic<std::uint64_t> total{0}; ///< Sum of the recorded values, in nanoseconds.
+    };
+
+    /**
+     * @brief The counters written by the threads mapped to one shard.
+     */
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<std::uint64_t> enqueued{0};
+        std::atomic<std::uint64_t> dispatched{0};
+        std::atomic<std::uint64_t> dropped{0};
+        HistogramCounters queueWait;
+        HistogramCounters handlerTime;
+    };
+
+    /**
+     * @brief Returns the shard of the calling thread.
+     */
+    Shard &shard() {
+        static std::atomic<std::size_t> nextThread{0};
+        thread_local const std::size_t index = nextThread.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+        return shards_[index];
+    }
+
+    std::size_t depth() const {
+        std::uint64_t removed = 0;
+        std::uint64_t enqueued = 0;
+        // Read the removals first: every counted removal then has its push counted as well.
+        for (const Shard &counters : shards_) {
+            removed += counters.dispatched.load(std::memory_order_relaxed) +
+                       counters.dropped.load(std::memory_order_relaxed);
+        }
+        for (const Shard &counters : shards_) {
+            enqueued += counters.enqueued.load(std::memory_order_relaxed);
+        }
+        return enqueued > removed ? static_cast<std::size_t>(enqueued - removed) : 0;
+    }
+
+    static void record(HistogramCounters &histogram, std::chrono::steady_clock::duration elapsed) {
+        const auto nanoseconds = static_cast<std::uint64_t>(
+            std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 0));
+        histogram.buckets[LatencyHistogram::bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        histogram.total.fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    static void merge(LatencyHistogram &into, const HistogramCounters &from) {
+        for (std::size_t bucket = 0; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+            const std::uint64_t count = from.buckets[bucket].load(std::memory_order_relaxed);
+            if (count != 0) {
+                into.add(bucket, count);
+            }
+        }
+        into.addTotal(from.total.load(std::memory_order_relaxed));
+    }
+
+    std::array<Shard, kShardCount> shards_;         ///< Counters, one cache-line-aligned block per shard.
+    std::atomic<std::size_t> highWaterMark_{0};     ///< See QueueMetricsSnapshot::highWaterMark.
+};
+
+#else // EVENT_QUEUE_ENABLE_METRICS
+
+/**
+ * @brief Empty stand-in for the push time when metrics are compiled out.
+ */
+class EnqueueStamp {
+public:
+    static EnqueueStamp now() { return {}; }
+};
+
+/**
+ * @brief No-op stand-in for the sharded metrics when they are compiled out.
+ */
+class QueueMetrics {
+public:
+    void recordEnqueue() {}
+    void recordDrop() {}
+
+    template <typename F>
+    void dispatch(EnqueueStamp, F &&run) {
+        std::forward<F>(run)();
+    }
+
+    template <typename F>
+    void time(F &&run) {
+        std::forward<F>(run)();
+    }
+
+    void sampleDepth() {}
+
+    QueueMetricsSnapshot snapshot() { return {}; }
+};
+
+#endif // EVENT_QUEUE_ENABLE_METRICS
+
+} // namespace event_queue
+
+#endif // QUEUE_METRICS_HPP
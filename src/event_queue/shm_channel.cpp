@@ -0,0 +1,350 @@
+/**
+ * @file shm_channel.cpp
+ * @brief Implementation of ShmChannel.
+ *
+ * The producer and the consumer each write one index in the shared header, on separate cache
+ * lines, and keep a private copy of the other side's index so that they only read the shared
+ * line when the ring looks full (or empty). Sleeping uses the Dekker-style handshake of
+ * EventQueue::waitForWork(): the consumer announces itself in the futex word and re-checks the
+ * ring, the producer publishes its record and then checks the word, and a fence on each side
+ * guarantees that at least one of them sees the other.
+ */
+
+#include "shm_channel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace event_queue {
+
+namespace {
+
+constexpr std::uint64_t kMagic = 0x314C4E4843484D53ull; // "SMHCHNL1"
+constexpr std::size_t kHeaderRegionSize = 4096;
+constexpr std::size_t kRecordHeaderSize = 8;
+constexpr std::size_t kRecordAlignment = 8;
+constexpr std::size_t kMinimumCapacity = 256;
+constexpr std::uint32_t kWrapMarker = UINT32_MAX;
+
+/**
+ * @brief The fixed header in front of every record.
+ */
+struct RecordHeader {
+    std::uint32_t size; ///< Payload size in bytes, or kWrapMarker.
+    std::uint32_t type; ///< Caller-defined record type.
+};
+static_assert(sizeof(RecordHeader) == kRecordHeaderSize);
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::uint32_t>::is_always_lock_free,
+              "ShmChannel: shared atomics must be lock-free to work across processes");
+
+constexpr std::size_t alignRecord(std::size_t value) {
+    return (value + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = kMinimumCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+[[noreturn]] void throwSystemError(const std::string &what) {
+    throw std::system_error(errno, std::generic_category(), "ShmChannel: " + what);
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Sleeps while @p word holds @p expected, at most until @p deadline.
+ *
+ * Spurious returns are fine: the caller re-checks the ring.
+ */
+void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected,
+               std::chrono::steady_clock::time_point deadline) {
+    const auto now = std::chrono::steady_clock::now();
+    if (deadline <= now) {
+        return;
+    }
+#if defined(__linux__)
+    const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+    timespec timeout{};
+    timespec *timeoutPointer = nullptr;
+    if (deadline != std::chrono::steady_clock::time_point::max()) {
+        timeout.tv_sec = static_cast<std::time_t>(remaining.count() / 1000000000);
+        timeout.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+        timeoutPointer = &timeout;
+    }
+    // Not FUTEX_PRIVATE_FLAG: the word is shared with another process.
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT, expected, timeoutPointer,
+              nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+        deadline - now, std::chrono::microseconds(50)));
+#endif
+}
+
+void futexWake(std::atomic<std::uint32_t> &word) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+    (void)word; // The consumer polls.
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief The start of the shared region.
+ */
+struct ShmChannel::SharedHeader {
+    std::atomic<std::uint64_t> magic;                  ///< kMagic once the creator has initialized the region.
+    std::uint64_t capacity;                            ///< Ring size in bytes.
+    alignas(64) std::atomic<std::uint64_t> tail;       ///< Producer index: bytes ever pushed.
+    std::atomic<std::uint32_t> closed;                 ///< Set by close().
+    alignas(64) std::atomic<std::uint64_t> head;       ///< Consumer index: bytes ever consumed.
+    alignas(64) std::atomic<std::uint32_t> sleeping;   ///< Futex word: 1 while the consumer is going to sleep.
+};
+
+ShmChannel::ShmChannel(const std::string &name, OpenMode mode) : ShmChannel(name, mode, Options{}) {}
+
+ShmChannel::ShmChannel(const std::string &name, OpenMode mode, const Options &options)
+    : name_(name), owner_(mode == OpenMode::Create), spinCount_(options.spinCount) {
+    static_assert(sizeof(SharedHeader) <= kHeaderRegionSize);
+    if (owner_) {
+        capacity_ = roundUpToPowerOfTwo(options.capacity);
+        mappingSize_ = kHeaderRegionSize + capacity_;
+        const int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            throwSystemError("cannot create " + name_);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(mappingSize_)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            ::shm_unlink(name_.c_str());
+            errno = error;
+            throwSystemError("cannot size " + name_);
+        }
+        mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            ::shm_unlink(name_.c_str());
+            errno = error;
+            throwSystemError("cannot map " + name_);
+        }
+        // A new shared memory object is zero-filled, so only the capacity and the magic
+        // number need writing; the magic is published last.
+        header_ = ::new (mapping_) SharedHeader{};
+        header_->capacity = capacity_;
+        header_->magic.store(kMagic, std::memory_order_release);
+    } else {
+        const int fd = ::shm_open(name_.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            throwSystemError("cannot open " + name_);
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0) {
+            const int error = errno;
+            ::close(fd);
+            errno = error;
+            throwSystemError("cannot stat " + name_);
+        }
+        mappingSize_ = static_cast<std::size_t>(status.st_size);
+        if (mappingSize_ < kHeaderRegionSize + kMinimumCapacity) {
+            ::close(fd);
+            throw std::runtime_error("ShmChannel: " + name_ + " is not a channel");
+        }
+        mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            errno = error;
+            throwSystemError("cannot map " + name_);
+        }
+        header_ = std::launder(reinterpret_cast<SharedHeader *>(mapping_));
+        capacity_ = header_->magic.load(std::memory_order_acquire) == kMagic ? header_->capacity : 0;
+        if (capacity_ == 0 || (capacity_ & (capacity_ - 1)) != 0 || kHeaderRegionSize + capacity_ != mappingSize_) {
+            ::munmap(mapping_, mappingSize_);
+            throw std::runtime_error("ShmChannel: " + name_ + " is not an initialized channel");
+        }
+    }
+    ring_ = static_cast<std::byte *>(mapping_) + kHeaderRegionSize;
+    cachedHead_ = header_->head.load(std::memory_order_acquire);
+    cachedTail_ = header_->tail.load(std::memory_order_acquire);
+}
+
+ShmChannel::~ShmChannel() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mappingSize_);
+    }
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+std::size_t ShmChannel::maxPayloadSize() const {
+    return capacity_ / 2 - kRecordHeaderSize;
+}
+
+bool ShmChannel::pushEvent(std::uint32_t type, std::span<const std::byte> payload) {
+    if (payload.size() > maxPayloadSize()) {
+        throw std::length_error("ShmChannel: record does not fit in the ring");
+    }
+    if (header_->closed.load(std::memory_order_relaxed) != 0) {
+        return false;
+    }
+    const std::uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    const std::size_t length = alignRecord(kRecordHeaderSize + payload.size());
+    const std::size_t offset = static_cast<std::size_t>(tail) & (capacity_ - 1);
+    // A record never wraps: if it does not fit before the end of the ring, the rest of the
+    // ring is skipped (offsets are 8-aligned, so there is always room for the marker).
+    const std::size_t skip = capacity_ - offset < length ? capacity_ - offset : 0;
+    const std::uint64_t end = tail + skip + length;
+    if (end - cachedHead_ > capacity_) {
+        // Looks full from the cached view: refresh it from the consumer's index.
+        cachedHead_ = header_->head.load(std::memory_order_acquire);
+        if (end - cachedHead_ > capacity_) {
+            return false;
+        }
+    }
+    std::byte *record = ring_ + offset;
+    if (skip != 0) {
+        const RecordHeader marker{kWrapMarker, 0};
+        std::memcpy(record, &marker, sizeof(marker));
+        record = ring_;
+    }
+    const RecordHeader recordHeader{static_cast<std::uint32_t>(payload.size()), type};
+    std::memcpy(record, &recordHeader, sizeof(recordHeader));
+    if (!payload.empty()) {
+        std::memcpy(record + kRecordHeaderSize, payload.data(), payload.size());
+    }
+    header_->tail.store(end, std::memory_order_release);
+    wakeConsumer();
+    return true;
+}
+
+void ShmChannel::wakeConsumer() {
+    // Paired with the fence in waitFor(): either the consumer sees the new tail, or we see
+    // that it is going to sleep. Only the first push after it went to sleep wakes it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->sleeping.load(std::memory_order_relaxed) != 0 &&
+        header_->sleeping.exchange(0, std::memory_order_relaxed) != 0) {
+        futexWake(header_->sleeping);
+    }
+}
+
+bool ShmChannel::front(Message &message) {
+    std::uint64_t head = header_->head.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+        cachedTail_ = header_->tail.load(std::memory_order_acquire);
+        if (head == cachedTail_) {
+            return false;
+        }
+    }
+    std::size_t offset = static_cast<std::size_t>(head) & (capacity_ - 1);
+    RecordHeader recordHeader;
+    std::memcpy(&recordHeader, ring_ + offset, sizeof(recordHeader));
+    std::size_t skip = 0;
+    if (recordHeader.size == kWrapMarker) {
+        // The producer wrote the record at the start of the ring in the same push.
+        skip = capacity_ - offset;
+        offset = 0;
+        std::memcpy(&recordHeader, ring_, sizeof(recordHeader));
+    }
+    if (recordHeader.size > maxPayloadSize()) {
+        throw std::runtime_error("ShmChannel: corrupt record in " + name_);
+    }
+    message.type = recordHeader.type;
+    message.payload = std::span<const std::byte>(ring_ + offset + kRecordHeaderSize, recordHeader.size);
+    frontLength_ = skip + alignRecord(kRecordHeaderSize + recordHeader.size);
+    return true;
+}
+
+void ShmChannel::popFront() {
+    // Hand the space back to the producer.
+    header_->head.store(header_->head.load(std::memory_order_relaxed) + frontLength_,
+                        std::memory_order_release);
+}
+
+bool ShmChannel::waitFor(std::chrono::nanoseconds timeout) {
+    using Clock = std::chrono::steady_clock;
+    const auto hasWork = [this]() {
+        return header_->tail.load(std::memory_order_acquire) != header_->head.load(std::memory_order_relaxed);
+    };
+    for (std::size_t spin = 0; spin < spinCount_; ++spin) {
+        if (hasWork()) {
+            return true;
+        }
+        if (isClosed()) {
+            return hasWork();
+        }
+        cpuRelax();
+    }
+    const Clock::time_point now = Clock::now();
+    const Clock::time_point deadline =
+        timeout >= Clock::time_point::max() - now ? Clock::time_point::max()
+                                                  : now + std::chrono::duration_cast<Clock::duration>(timeout);
+    while (true) {
+        if (hasWork()) {
+            return true;
+        }
+        if (isClosed() || Clock::now() >= deadline) {
+            return hasWork();
+        }
+        // Announce the sleeper before re-checking the ring; paired with wakeConsumer().
+        header_->sleeping.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!hasWork() && !isClosed()) {
+            futexWait(header_->sleeping, 1, deadline);
+        }
+        header_->sleeping.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ShmChannel::close() {
+    header_->closed.store(1, std::memory_order_release);
+    wakeConsumer();
+}
+
+bool ShmChannel::isClosed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool ShmChannel::isEmpty() const {
+    return header_->head.load(std::memory_order_relaxed) == header_->tail.load(std::memory_order_acquire);
+}
+
+} // namespace event_queue
@@ -0,0 +1,225 @@
+#ifndef SHM_CHANNEL_HPP
+#define SHM_CHANNEL_HPP
+
+/**
+ * @file shm_channel.hpp
+ * @brief Declaration of ShmChannel, a cross-process event ring in POSIX shared memory.
+ *
+ * Processes on the same host can exchange events through loopback sockets, but every message
+ * then costs system calls and copies through the kernel. ShmChannel instead places a
+ * single-producer/single-consumer ring of length-prefixed records in a shared memory object
+ * (shm_open() and mmap()). Pushing is a copy into the ring and a release store of the tail
+ * index; processing hands the consumer views straight into the ring.
+ *
+ * A consumer waiting for events spins for a while (Options::spinCount) and then sleeps. On
+ * Linux, it sleeps on a futex in the shared region, and a producer makes the wake-up system
+ * call only when the consumer is actually asleep. Other POSIX systems poll with short sleeps.
+ *
+ * In the shared region, a header page holds the indices and is followed by the ring. A record
+ * is laid out as follows, padded to a multiple of 8 bytes and never split across the end of
+ * the ring:
+ * @code
+ * uint32 size      payload size in bytes (kWrapMarker: skip to the start of the ring)
+ * uint32 type      caller-defined record type
+ * payload[size]
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+
+namespace event_queue {
+
+/**
+ * @brief A bounded cross-process event channel for one producer and one consumer.
+ *
+ * One process creates the channel (OpenMode::Create) and owns its name: the shared memory
+ * object is unlinked when the creating ShmChannel is destroyed. The other process attaches with
+ * OpenMode::Open. Producer calls (pushEvent(), close()) must come from one thread at a time in
+ * one process, and consumer calls (processEvents(), waitFor(), waitAndProcess()) from one thread
+ * at a time in the other. The two sides may also live in the same process.
+ *
+ * The API follows EventQueue's push/process shape:
+ * @code
+ * // Consumer process.
+ * ShmChannel channel("/prices", ShmChannel::OpenMode::Create);
+ * while (channel.waitAndProcess([](const ShmChannel::Message &message) { handle(message); })) {
+ * }
+ *
+ * // Producer process.
+ * ShmChannel channel("/prices", ShmChannel::OpenMode::Open);
+ * channel.pushEvent(kQuote, Quote{42, 100.25});
+ * channel.close();
+ * @endcode
+ */
+class ShmChannel {
+public:
+    /**
+     * @brief Selects whether the constructor creates the shared memory object or attaches to it.
+     */
+    enum class OpenMode {
+        Create, ///< Create a new channel (fails if the name exists) and unlink it on destruction.
+        Open    ///< Attach to a channel created by another ShmChannel.
+    };
+
+    /**
+     * @brief Construction-time configuration of a channel.
+     */
+    struct Options {
+        /// Size of the ring in bytes, rounded up to a power of two. Only used by OpenMode::Create.
+        std::size_t capacity = std::size_t{1} << 20;
+        /// How many times a waiting consumer checks for events before it goes to sleep.
+        std::size_t spinCount = 4096;
+    };
+
+    /**
+     * @brief One received record. The payload stays valid until the handler returns.
+     */
+    struct Message {
+        std::uint32_t type = 0;
+        std::span<const std::byte> payload;
+    };
+
+    /**
+     * @brief Creates or attaches to the channel @p name with the default options.
+     */
+    ShmChannel(const std::string &name, OpenMode mode);
+
+    /**
+     * @brief Creates or attaches to the channel @p name.
+     *
+     * @param name The shared memory object name, as for shm_open() (e.g. "/prices").
+     * @param mode Whether to create the channel or attach to an existing one.
+     * @param options The ring capacity (when creating) and the consumer's spin count.
+     * @throws std::system_error if the shared memory object cannot be created, opened or mapped.
+     * @throws std::runtime_error if an existing object is not an initialized channel.
+     */
+    ShmChannel(const std::string &name, OpenMode mode, const Options &options);
+
+    ShmChannel(const ShmChannel &) = delete;
+    ShmChannel &operator=(const ShmChannel &) = delete;
+
+    /**
+     * @brief Unmaps the channel, and unlinks its name if this object created it.
+     */
+    ~ShmChannel();
+
+    /**
+     * @brief Appends one record without blocking (producer only).
+     *
+     * @param type A caller-defined tag returned with the record.
+     * @param payload The record bytes.
+     * @return true if the record was stored, false if the ring is full or the channel is closed.
+     * @throws std::length_error if the record is larger than maxPayloadSize().
+     */
+    bool pushEvent(std::uint32_t type, std::span<const std::byte> payload);
+
+    /**
+     * @brief Appends a trivially copyable value as a record of @p type (producer only).
+     */
+    template <typename T>
+        requires(std::is_trivially_copyable_v<T> && !std::is_convertible_v<const T &, std::span<const std::byte>>)
+    bool pushEvent(std::uint32_t type, const T &value) {
+        return pushEvent(type, std::span<const std::byte>(reinterpret_cast<const std::byte *>(&value), sizeof(T)));
+    }
+
+    /**
+     * @brief Calls @p handler with every record available now, in push order (consumer only).
+     *
+     * Each record's space is handed back to the producer as soon as its handler returns.
+     *
+     * @return The number of records processed.
+     */
+    template <typename F>
+    std::size_t processEvents(F &&handler) {
+        std::size_t count = 0;
+        Message message;
+        while (front(message)) {
+            handler(static_cast<const Message &>(message));
+            popFront();
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Waits until records are available, the channel is closed or @p timeout elapses.
+     *
+     * @return true if records are available, false otherwise.
+     */
+    bool waitFor(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Waits for records and processes them (consumer only).
+     *
+     * @return false once the channel is closed and drained, true otherwise.
+     */
+    template <typename F>
+    bool waitAndProcess(F &&handler) {
+        if (!waitFor(std::chrono::nanoseconds::max())) {
+            return false;
+        }
+        processEvents(handler);
+        return true;
+    }
+
+    /**
+     * @brief Marks the channel closed and wakes the consumer (producer only).
+     *
+     * Records already pushed can still be processed; further pushes fail.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether close() has been called.
+     */
+    bool isClosed() const;
+
+    /**
+     * @brief Checks whether no records are waiting. Only a snapshot while the producer is pushing.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Returns the ring size in bytes.
+     */
+    std::size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Returns the largest payload a single record may carry.
+     */
+    std::size_t maxPayloadSize() const;
+
+    /**
+     * @brief Returns the shared memory object name.
+     */
+    const std::string &name() const { return name_; }
+
+private:
+    struct SharedHeader;
+
+    bool front(Message &message);
+    void popFront();
+    void wakeConsumer();
+
+    std::string name_;               ///< The shared memory object name.
+    bool owner_;                     ///< Whether this object created (and unlinks) the name.
+    std::size_t spinCount_;          ///< Polls before a waiting consumer sleeps.
+    void *mapping_ = nullptr;        ///< The whole shared region.
+    std::size_t mappingSize_ = 0;    ///< Size of the shared region.
+    SharedHeader *header_ = nullptr; ///< The indices at the start of the region.
+    std::byte *ring_ = nullptr;      ///< The record ring after the header.
+    std::size_t capacity_ = 0;       ///< Ring size in bytes (a power of two).
+    std::uint64_t cachedHead_ = 0;   ///< Producer's view of the consumer index.
+    std::uint64_t cachedTail_ = 0;   ///< Consumer's view of the producer index.
+    std::size_t frontLength_ = 0;    ///< Length of the record returned by front(), including skipped padding.
+};
+
+} // namespace event_queue
+
+#endif // SHM_CHANNEL_HPP
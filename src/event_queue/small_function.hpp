@@ -0,0 +1,244 @@
+#ifndef SMALL_FUNCTION_HPP
+#define SMALL_FUNCTION_HPP
+
+/**
+ * @file small_function.hpp
+ * @brief Declaration of SmallFunction, a move-only callable wrapper with inline storage.
+ *
+ * std::function must be copyable and only guarantees inline storage for very small callables,
+ * so most capturing lambdas cost a heap allocation when they are wrapped. SmallFunction stores
+ * any callable of up to @c Capacity bytes directly inside the wrapper and only falls back to
+ * the heap for larger ones. Because it is move-only, it can also hold move-only captures such
+ * as std::unique_ptr.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace event_queue {
+
+/**
+ * @brief Default inline capacity, in bytes, of a SmallFunction.
+ *
+ * Together with the dispatch pointer this makes a SmallFunction exactly one 64-byte cache line.
+ */
+inline constexpr std::size_t kDefaultSmallFunctionCapacity = 56;
+
+template <typename Signature, std::size_t Capacity = kDefaultSmallFunctionCapacity>
+class SmallFunction;
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool isStdFunction = false;
+
+template <typename Signature>
+inline constexpr bool isStdFunction<std::function<Signature>> = true;
+
+/**
+ * @brief Tells whether @p f is a callable that holds nothing to call, as std::function does.
+ *
+ * True for a null function or member pointer and for an empty std::function.
+ */
+template <typename F>
+bool isEmptyCallable(const F &f) noexcept {
+    if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F>) {
+        return f == nullptr;
+    } else if constexpr (isStdFunction<F>) {
+        return !f;
+    } else {
+        return false;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief A move-only type-erased callable with a small-buffer optimization.
+ *
+ * A callable is stored inline when it fits in @p Capacity bytes, does not require more than
+ * std::max_align_t alignment and is nothrow move-constructible; constructing, moving, invoking
+ * and destroying such a SmallFunction never touches the allocator. Other callables are stored
+ * on the heap.
+ *
+ * @tparam R The return type.
+ * @tparam Args The argument types.
+ * @tparam Capacity The size of the inline buffer in bytes.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class SmallFunction<R(Args...), Capacity> {
+    static_assert(Capacity >= sizeof(void *), "SmallFunction capacity must hold at least a pointer.");
+
+public:
+    /**
+     * @brief Tells whether a callable of type @p F is stored inline (without allocating).
+     */
+    template <typename F>
+    static constexpr bool fitsInline = sizeof(F) <= Capacity &&
+                                       alignof(F) <= alignof(std::max_align_t) &&
+                                       std::is_nothrow_move_constructible_v<F>;
+
+    /**
+     * @brief Constructs an empty SmallFunction.
+     */
+    SmallFunction() noexcept = default;
+
+    /**
+     * @brief Constructs an empty SmallFunction.
+     */
+    SmallFunction(std::nullptr_t) noexcept {}
+
+    /**
+     * @brief Constructs a SmallFunction holding a copy (or move) of @p f.
+     *
+     * Like std::function, the SmallFunction is left empty if @p f is a null function pointer
+     * or an empty std::function.
+     *
+     * @param f The callable to store.
+     */
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, SmallFunction> &&
+                 std::is_invocable_r_v<R, std::decay_t<F> &, Args...>)
+    SmallFunction(F &&f) {
+        if (!detail::isEmptyCallable(f)) {
+            construct<std::decay_t<F>>(std::forward<F>(f));
+        }
+    }
+
+    /**
+     * @brief Constructs a callable of type @p F in place from @p args.
+     *
+     * @param args The arguments forwarded to the constructor of @p F.
+     */
+    template <typename F, typename... CtorArgs>
+        requires std::is_invocable_r_v<R, F &, Args...>
+    explicit SmallFunction(std::in_place_type_t<F>, CtorArgs &&...args) {
+        construct<F>(std::forward<CtorArgs>(args)...);
+    }
+
+    /**
+     * @brief Move constructor. Leaves @p other empty.
+     */
+    SmallFunction(SmallFunction &&other) noexcept { moveFrom(other); }
+
+    /**
+     * @brief Move assignment. Leaves @p other empty.
+     */
+    SmallFunction &operator=(SmallFunction &&other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destroys the stored callable, leaving this SmallFunction empty.
+     */
+    SmallFunction &operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    SmallFunction(const SmallFunction &) = delete;
+    SmallFunction &operator=(const SmallFunction &) = delete;
+
+    /**
+     * @brief Destroys the stored callable, if any.
+     */
+    ~SmallFunction() { reset(); }
+
+    /**
+     * @brief Checks whether a callable is stored.
+     */
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    /**
+     * @brief Invokes the stored callable. The SmallFunction must not be empty.
+     */
+    R operator()(Args... args) { return ops_->invoke(buffer_, std::forward<Args>(args)...); }
+
+    /**
+     * @brief Checks whether the stored callable lives in the inline buffer.
+     *
+     * @return true if the SmallFunction is empty or its callable is stored inline.
+     */
+    bool isInline() const noexcept { return ops_ == nullptr || !ops_->onHeap; }
+
+    /**
+     * @brief Returns the size of the inline buffer in bytes.
+     */
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+private:
+    /**
+     * @brief Per-callable-type operations used for type erasure.
+     */
+    struct Ops {
+        R (*invoke)(void *, Args &&...);
+        void (*relocate)(void *dst, void *src) noexcept; ///< Move-constructs into dst, destroys src.
+        void (*destroy)(void *) noexcept;
+        bool onHeap;
+    };
+
+    template <typename F>
+    struct InlineOps {
+        static F *get(void *p) noexcept { return std::launder(static_cast<F *>(p)); }
+        static R invoke(void *p, Args &&...args) {
+            return std::invoke(*get(p), std::forward<Args>(args)...);
+        }
+        static void relocate(void *dst, void *src) noexcept {
+            ::new (dst) F(std::move(*get(src)));
+            get(src)->~F();
+        }
+        static void destroy(void *p) noexcept { get(p)->~F(); }
+        static constexpr Ops ops{&invoke, &relocate, &destroy, false};
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static F *&get(void *p) noexcept { return *std::launder(static_cast<F **>(p)); }
+        static R invoke(void *p, Args &&...args) {
+            return std::invoke(*get(p), std::forward<Args>(args)...);
+        }
+        static void relocate(void *dst, void *src) noexcept { ::new (dst) F *(get(src)); }
+        static void destroy(void *p) noexcept { delete get(p); }
+        static constexpr Ops ops{&invoke, &relocate, &destroy, true};
+    };
+
+    template <typename F, typename... CtorArgs>
+    void construct(CtorArgs &&...args) {
+        if constexpr (fitsInline<F>) {
+            ::new (static_cast<void *>(buffer_)) F(std::forward<CtorArgs>(args)...);
+            ops_ = &InlineOps<F>::ops;
+        } else {
+            ::new (static_cast<void *>(buffer_)) F *(new F(std::forward<CtorArgs>(args)...));
+            ops_ = &HeapOps<F>::ops;
+        }
+    }
+
+    void moveFrom(SmallFunction &other) noexcept {
+        if (other.ops_) {
+            other.ops_->relocate(buffer_, other.buffer_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(buffer_);
+            ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char buffer_[Capacity]; ///< Inline callable storage.
+    const Ops *ops_ = nullptr; ///< Operations for the stored callable, or nullptr when empty.
+};
+
+} // namespace event_queue
+
+#endif // SMALL_FUNCTION_HPP
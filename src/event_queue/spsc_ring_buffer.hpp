@@ -0,0 +1,173 @@
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+/**
+ * @file spsc_ring_buffer.hpp
+ * @brief Declaration of a bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * This file declares the SpscRingBuffer class template, which EventQueue gives to every
+ * registered producer. With exactly one writer per index, a push is a plain store followed by
+ * a release store of the tail: no compare-and-swap and no cache line shared with other
+ * producers. Each side also keeps a private copy of the other side's index, so it only reads
+ * the shared line when its cached view says the buffer is full (or empty).
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+#include "mpsc_ring_buffer.hpp"
+
+namespace event_queue {
+
+/**
+ * @brief A bounded lock-free ring buffer for one producer and one consumer.
+ *
+ * tryPush() must only be called from one producer thread at a time, and tryPop() and front()
+ * from one consumer thread at a time. The capacity is rounded up to the next power of two.
+ *
+ * @tparam T The element type. It must be move-constructible.
+ */
+template <typename T>
+class SpscRingBuffer {
+public:
+    /**
+     * @brief Constructs a ring buffer able to hold at least @p capacity elements.
+     *
+     * @param capacity The requested capacity. It is rounded up to a power of two (minimum 2).
+     */
+    explicit SpscRingBuffer(std::size_t capacity)
+        : capacity_(roundUpToPowerOfTwo(capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_)) {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    /**
+     * @brief Destroys any elements that were pushed but never popped.
+     */
+    ~SpscRingBuffer() {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        for (std::size_t pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            element(pos)->~T();
+        }
+    }
+
+    /**
+     * @brief Attempts to append an element (producer only).
+     *
+     * @param value The element to move into the buffer.
+     * @return true if the element was stored, false if the buffer was full.
+     */
+    bool tryPush(T &&value) {
+        const std::size_t pos = tail_.load(std::memory_order_relaxed);
+        if (pos - cachedHead_ == capacity_) {
+            // Looks full from the cached view: refresh it from the consumer's index.
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (pos - cachedHead_ == capacity_) {
+                return false;
+            }
+        }
+        ::new (slots_[pos & mask_].bytes) T(std::move(value));
+        tail_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns the oldest element without removing it, or nullptr if empty (consumer only).
+     */
+    T *front() {
+        const std::size_t pos = head_.load(std::memory_order_relaxed);
+        if (pos == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (pos == cachedTail_) {
+                return nullptr;
+            }
+        }
+        return element(pos);
+    }
+
+    /**
+     * @brief Attempts to remove the oldest element (consumer only).
+     *
+     * @param out Receives the element on success.
+     * @return true if an element was removed, false if the buffer was empty.
+     */
+    bool tryPop(T &out) {
+        T *value = front();
+        if (value == nullptr) {
+            return false;
+        }
+        out = std::move(*value);
+        value->~T();
+        // Hand the slot back to the producer.
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the buffer is empty. Only a snapshot while the producer is pushing.
+     */
+    bool empty() const {
+        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns an approximate number of elements in the buffer.
+     */
+    std::size_t sizeApprox() const {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Returns the actual (power-of-two) capacity of the buffer.
+     */
+    std::size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Returns the bytes of the slot array (e.g. to place it with bindToNumaNode()).
+     */
+    std::span<const std::byte> storage() const {
+        return std::as_bytes(std::span(slots_.get(), capacity_));
+    }
+
+private:
+    /**
+     * @brief Uninitialized storage for one element.
+     */
+    struct Slot {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    T *element(std::size_t pos) {
+        return std::launder(reinterpret_cast<T *>(slots_[pos & mask_].bytes));
+    }
+
+    const std::size_t capacity_;    ///< Number of slots (a power of two).
+    const std::size_t mask_;        ///< capacity_ - 1, used to map indices to slots.
+    std::unique_ptr<Slot[]> slots_; ///< The slot array.
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0}; ///< Next position the producer writes.
+    std::size_t cachedHead_ = 0;                                ///< Producer's last view of head_.
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0}; ///< Next position the consumer reads.
+    std::size_t cachedTail_ = 0;                                ///< Consumer's last view of tail_.
+};
+
+} // namespace event_queue
+
+#endif // SPSC_RING_BUFFER_HPP
@@ -0,0 +1,144 @@
+/**
+ * @file strand.cpp
+ * @brief Implementation of the Strand class.
+ *
+ * A strand's pending events sit in a mutex-protected CircularBuffer. The first post to an idle
+ * strand submits, under the mutex, one executor event that swaps the whole buffer out, runs it
+ * unlocked and then either marks the strand idle or resubmits itself, so a strand is scheduled
+ * on at most one worker at a time. A run that the executor destroys without running it (under
+ * ShutdownMode::Discard) marks the strand idle and drops its pending events, so that later
+ * posts report the failure.
+ */
+
+#include "strand.hpp"
+
+#include <cstdint>
+#include <mutex>
+
+#include "circular_buffer.hpp"
+
+namespace event_queue {
+
+/**
+ * @brief The shared state of a strand.
+ */
+struct Strand::State {
+    explicit State(Executor &executor) : executor(&executor) {}
+
+    Executor *executor;             ///< Runs the strand's events.
+    std::mutex mutex;               ///< Protects pending, scheduled and generation.
+    CircularBuffer<Event> pending;  ///< Posted events not yet taken by a run.
+    bool scheduled = false;         ///< Whether an executor event for this strand is queued or running.
+    std::uint64_t generation = 0;   ///< Number of runs created; identifies the scheduled one.
+};
+
+/**
+ * @brief The executor event that drains a strand.
+ *
+ * Destroying it without running it means the executor dropped it. If it is still the
+ * scheduled run, the strand goes idle and its pending events are dropped with it.
+ */
+class Strand::Run {
+public:
+    /**
+     * @brief Creates the next run of @p state. Must be called with the strand's mutex held.
+     */
+    explicit Run(std::shared_ptr<State> state) : state_(std::move(state)), generation_(++state_->generation) {}
+
+    Run(Run &&) noexcept = default;
+    Run &operator=(Run &&) = delete;
+
+    ~Run() {
+        if (!state_) {
+            return; // Moved from, or already run.
+        }
+        CircularBuffer<Event> dropped; // Destroyed after the lock is released.
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->scheduled && state_->generation == generation_) {
+            dropped.swap(state_->pending);
+            state_->scheduled = false;
+        }
+    }
+
+    void operator()() { Strand::run(std::move(state_)); }
+
+private:
+    std::shared_ptr<State> state_; ///< The strand to drain; null once run.
+    std::uint64_t generation_;     ///< The value of State::generation this run was created with.
+};
+
+namespace {
+
+/**
+ * @brief The strand whose events the calling thread is running, if any.
+ */
+thread_local const void *currentStrand = nullptr;
+
+} // namespace
+
+Strand::Strand(Executor &executor) : state_(std::make_shared<State>(executor)) {
+}
+
+bool Strand::post(Event &&event) {
+    // Destroyed after the lock is released.
+    CircularBuffer<Event> dropped;
+    Event refused;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->pending.push(std::move(event));
+    if (state_->scheduled) {
+        return true; // The running (or queued) run will pick it up.
+    }
+    // Submit under the lock, so that concurrent posters wait for the outcome instead of
+    // queueing behind a run that the executor may refuse.
+    refused = Event(Run(state_));
+    if (state_->executor->submit(std::move(refused))) {
+        state_->scheduled = true;
+        return true;
+    }
+    // The executor is shut down: nothing will run the strand. The strand was idle, so the
+    // only pending event is the one just posted.
+    dropped.swap(state_->pending);
+    return false;
+}
+
+bool Strand::runningInThisThread() const {
+    return currentStrand == state_.get();
+}
+
+Executor &Strand::executor() const {
+    return *state_->executor;
+}
+
+void Strand::run(std::shared_ptr<State> state) {
+    CircularBuffer<Event> batch;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        batch.swap(state->pending);
+    }
+    // Run the batch unlocked; events posted meanwhile land in pending and wait for the next run.
+    const void *previous = currentStrand;
+    currentStrand = state.get();
+    while (!batch.empty()) {
+        Event event = std::move(batch.front());
+        batch.pop();
+        if (event) {
+            event();
+        }
+    }
+    currentStrand = previous;
+    Event next;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->pending.empty()) {
+            // Go idle. The batch storage is released with it, so idle strands stay small.
+            state->scheduled = false;
+            return;
+        }
+        next = Event(Run(state));
+    }
+    // More events arrived: requeue instead of looping, so other work gets a turn on this worker.
+    // Resubmitting from a worker succeeds even while the executor drains on shutdown.
+    state->executor->submit(std::move(next));
+}
+
+} // namespace event_queue
@@ -0,0 +1,95 @@
+#ifndef STRAND_HPP
+#define STRAND_HPP
+
+/**
+ * @file strand.hpp
+ * @brief Declaration of the Strand class, a serial FIFO lane on top of an Executor.
+ *
+ * An Executor runs events concurrently and in any order. Work that belongs to one entity (a
+ * session, an account) often has to run in order and never concurrently with itself, while
+ * different entities should still run in parallel. A Strand gives each entity such a lane
+ * without giving it a thread or an EventQueue: events posted to the same strand run one at a
+ * time in FIFO order, while any number of strands share the executor's workers.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "executor.hpp"
+
+namespace event_queue {
+
+/**
+ * @brief A handle to a serial FIFO lane whose events run on a shared Executor.
+ *
+ * Events posted to a strand never run concurrently with each other and run in the order they
+ * were posted (events posted concurrently from different threads are ordered by their arrival
+ * at the strand). At most one executor event exists per strand at a time: it runs every event
+ * that was pending when it started and resubmits itself if more arrived meanwhile, so a busy
+ * strand cannot monopolize a worker and an idle strand costs nothing but its memory.
+ *
+ * Strand is a cheap, copyable handle: copies refer to the same lane. A strand takes one heap
+ * allocation when created and none when idle. Events still pending when the last handle is
+ * destroyed are run anyway; the executor must outlive them.
+ */
+class Strand {
+public:
+    /**
+     * @brief Type alias for the unit of work; the same callable type as EventQueue::Event.
+     */
+    using Event = Executor::Event;
+
+    /**
+     * @brief Creates an empty strand whose events run on @p executor.
+     */
+    explicit Strand(Executor &executor);
+
+    /**
+     * @brief Appends an event to the strand.
+     *
+     * @param event The event to run. It is moved into the strand.
+     * @return true if the event was accepted, false if the executor has been shut down and
+     *         the strand had to be scheduled to run it (or its run was discarded by
+     *         ShutdownMode::Discard). An accepted event runs unless it is discarded too.
+     */
+    bool post(Event &&event);
+
+    /**
+     * @brief Appends any callable to the strand as an event.
+     *
+     * @param callable The callable to run.
+     * @return true if the event was accepted; see post(Event &&).
+     */
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, Event> && std::is_constructible_v<Event, F>)
+    bool post(F &&callable) {
+        return post(Event(std::forward<F>(callable)));
+    }
+
+    /**
+     * @brief Checks whether the calling thread is currently running an event of this strand.
+     */
+    bool runningInThisThread() const;
+
+    /**
+     * @brief Returns the executor that runs the strand's events.
+     */
+    Executor &executor() const;
+
+private:
+    struct State;
+    class Run;
+
+    /**
+     * @brief Runs the pending events of @p state and reschedules it if more arrived.
+     */
+    static void run(std::shared_ptr<State> state);
+
+    std::shared_ptr<State> state_; ///< The lane, shared with the executor event that drains it.
+};
+
+} // namespace event_queue
+
+#endif // STRAND_HPP
@@ -0,0 +1,219 @@
+/**
+ * @file thread_affinity.cpp
+ * @brief Implementation of the CPU topology, pinning and NUMA placement helpers.
+ */
+
+#include "thread_affinity.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace event_queue {
+
+namespace {
+
+/**
+ * @brief Parses a kernel CPU list such as "0-3,8,10-11".
+ */
+std::vector<unsigned> parseCpuList(const std::string &text) {
+    std::vector<unsigned> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        try {
+            const std::size_t dash = range.find('-');
+            const unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            const unsigned last =
+                dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            for (unsigned cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception &) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief Formats ascending CPU numbers as a kernel-style list ("0-3,8").
+ */
+std::string formatCpuList(const std::vector<unsigned> &cpus) {
+    std::string text;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        text += (text.empty() ? "" : ",") + std::to_string(cpus[i]);
+        if (j > i) {
+            text += "-" + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return text;
+}
+
+#if defined(__linux__)
+std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    std::string text;
+    std::getline(file, text);
+    return text;
+}
+#endif
+
+std::vector<CpuInfo> discoverCpus() {
+    std::vector<CpuInfo> cpus;
+#if defined(__linux__)
+    for (unsigned cpu : parseCpuList(readFile("/sys/devices/system/cpu/online"))) {
+        CpuInfo info;
+        info.cpu = cpu;
+        const std::string package =
+            readFile("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/physical_package_id");
+        info.package = package.empty() ? 0 : std::max(0, std::atoi(package.c_str()));
+        cpus.push_back(info);
+    }
+    // Node numbers may be sparse; the kernel lists the possible ones.
+    const std::string possible = readFile("/sys/devices/system/node/possible");
+    for (unsigned node : parseCpuList(possible)) {
+        const std::string list = readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        for (unsigned cpu : parseCpuList(list)) {
+            for (CpuInfo &info : cpus) {
+                if (info.cpu == cpu) {
+                    info.node = static_cast<int>(node);
+                }
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(CpuInfo{cpu, 0, 0});
+        }
+    }
+    return cpus;
+}
+
+} // namespace
+
+const CpuTopology &CpuTopology::system() {
+    static const CpuTopology topology(discoverCpus());
+    return topology;
+}
+
+CpuTopology::CpuTopology(std::vector<CpuInfo> cpus) : cpus_(std::move(cpus)) {
+    std::sort(cpus_.begin(), cpus_.end(), [](const CpuInfo &a, const CpuInfo &b) { return a.cpu < b.cpu; });
+}
+
+std::size_t CpuTopology::nodeCount() const {
+    std::set<int> nodes;
+    for (const CpuInfo &info : cpus_) {
+        nodes.insert(info.node);
+    }
+    return nodes.size();
+}
+
+int CpuTopology::nodeOf(unsigned cpu) const {
+    for (const CpuInfo &info : cpus_) {
+        if (info.cpu == cpu) {
+            return info.node;
+        }
+    }
+    return -1;
+}
+
+std::vector<unsigned> CpuTopology::cpusOnNode(int node) const {
+    std::vector<unsigned> cpus;
+    for (const CpuInfo &info : cpus_) {
+        if (info.node == node) {
+            cpus.push_back(info.cpu);
+        }
+    }
+    return cpus;
+}
+
+std::string CpuTopology::describe() const {
+    std::set<int> nodes;
+    std::set<int> packages;
+    for (const CpuInfo &info : cpus_) {
+        nodes.insert(info.node);
+        packages.insert(info.package);
+    }
+    const auto plural = [](std::size_t count, const char *noun) {
+        return std::to_string(count) + " " + noun + (count == 1 ? "" : "s");
+    };
+    std::string text = plural(nodes.size(), "NUMA node") + ", " + plural(packages.size(), "package") + ", " +
+                       plural(cpus_.size(), "CPU") + " (";
+    for (int node : nodes) {
+        text += (node == *nodes.begin() ? "" : "; ") + std::string("node ") + std::to_string(node) + ": " +
+                formatCpuList(cpusOnNode(node));
+    }
+    return text + ")";
+}
+
+bool pinCurrentThread(unsigned cpu) {
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+int currentCpu() {
+#if defined(__linux__)
+    return ::sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+bool bindToNumaNode(const void *address, std::size_t bytes, int node) {
+    if (node < 0) {
+        return false;
+    }
+#if defined(__linux__)
+    const auto pageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto start = reinterpret_cast<std::uintptr_t>(address);
+    const std::uintptr_t begin = (start + pageSize - 1) & ~(pageSize - 1);
+    const std::uintptr_t end = (start + bytes) & ~(pageSize - 1);
+    if (begin >= end) {
+        return true;
+    }
+    constexpr std::size_t kBitsPerWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> mask(static_cast<std::size_t>(node) / kBitsPerWord + 1, 0);
+    mask.back() = 1ul << (static_cast<std::size_t>(node) % kBitsPerWord);
+    // The kernel reads maxnode - 1 bits of the mask.
+    const unsigned long maxNode = mask.size() * kBitsPerWord + 1;
+    return ::syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED, mask.data(), maxNode, MPOL_MF_MOVE) == 0;
+#else
+    (void)address;
+    (void)bytes;
+    return false;
+#endif
+}
+
+} // namespace event_queue
@@ -0,0 +1,145 @@
+#ifndef THREAD_AFFINITY_HPP
+#define THREAD_AFFINITY_HPP
+
+/**
+ * @file thread_affinity.hpp
+ * @brief CPU topology discovery, thread pinning and NUMA memory placement.
+ *
+ * On a multi-socket machine, a consumer thread that the scheduler moves to another socket
+ * loses its warm caches, and every access to queue storage on its old node becomes a remote
+ * memory access. These helpers let the Executor pin its workers to chosen CPUs and let an
+ * EventQueue place its ring storage and payload arena on its consumer's NUMA node.
+ *
+ * Everything here is best effort. The topology comes from /sys on Linux. Pinning uses
+ * sched_setaffinity(), and placement uses the mbind() system call directly, so libnuma is not
+ * needed. On other systems the topology is a single node, and pinning and binding report
+ * failure.
+ */
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace event_queue {
+
+/**
+ * @brief The location of one online CPU.
+ */
+struct CpuInfo {
+    unsigned cpu = 0; ///< Operating system CPU number.
+    int node = 0;     ///< NUMA node the CPU belongs to.
+    int package = 0;  ///< Physical package (socket) the CPU belongs to.
+};
+
+/**
+ * @brief The online CPUs of the machine, with their NUMA nodes and packages.
+ */
+class CpuTopology {
+public:
+    /**
+     * @brief Returns the topology of this machine, discovered on first use.
+     */
+    static const CpuTopology &system();
+
+    /**
+     * @brief Builds a topology from an explicit CPU list (e.g. for tests).
+     */
+    explicit CpuTopology(std::vector<CpuInfo> cpus);
+
+    /**
+     * @brief Returns the online CPUs in ascending order.
+     */
+    const std::vector<CpuInfo> &cpus() const { return cpus_; }
+
+    /**
+     * @brief Returns the number of NUMA nodes that have CPUs.
+     */
+    std::size_t nodeCount() const;
+
+    /**
+     * @brief Returns the NUMA node of @p cpu, or -1 if the CPU is not online.
+     */
+    int nodeOf(unsigned cpu) const;
+
+    /**
+     * @brief Returns the online CPUs of NUMA node @p node.
+     */
+    std::vector<unsigned> cpusOnNode(int node) const;
+
+    /**
+     * @brief Returns a one-line summary, e.g. "2 NUMA nodes, 2 packages, 16 CPUs (node 0: 0-7; node 1: 8-15)".
+     */
+    std::string describe() const;
+
+private:
+    std::vector<CpuInfo> cpus_; ///< Online CPUs in ascending order.
+};
+
+/**
+ * @brief Restricts the calling thread to @p cpu.
+ *
+ * @return true on success, false if the CPU is unavailable or pinning is unsupported.
+ */
+bool pinCurrentThread(unsigned cpu);
+
+/**
+ * @brief Returns the CPU the calling thread is running on, or -1 if unknown.
+ */
+int currentCpu();
+
+/**
+ * @brief Asks the kernel to keep the whole pages of @p storage on NUMA node @p node.
+ *
+ * Pages that are already in memory are migrated, and later page faults in the range allocate
+ * from the node (or from another node if it runs out). Only the pages that lie entirely inside
+ * the range are affected, so memory shared with neighbouring allocations is left alone.
+ *
+ * @return true if the range was bound or contains no whole page; false if @p node is negative,
+ *         the call failed, or binding is unsupported.
+ */
+bool bindToNumaNode(const void *address, std::size_t bytes, int node);
+
+/**
+ * @brief A memory resource whose allocations are bound to one NUMA node.
+ *
+ * Allocations come from @p upstream and are then passed to bindToNumaNode(). A node of -1
+ * leaves placement to the operating system (normally the node of the thread that first writes
+ * the memory). Use it as the upstream of a PayloadArena to keep payload chunks near the
+ * consumer, ideally with page-aligned allocations.
+ */
+class NumaMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit NumaMemoryResource(int node = -1,
+                                std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : node_(node), upstream_(upstream) {}
+
+    /**
+     * @brief Returns the node allocations are bound to, or -1.
+     */
+    int node() const { return node_; }
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void *p = upstream_->allocate(bytes, alignment);
+        if (node_ >= 0) {
+            bindToNumaNode(p, bytes, node_);
+        }
+        return p;
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    int node_;                             ///< Target node, or -1.
+    std::pmr::memory_resource *upstream_;  ///< Where the memory comes from.
+};
+
+} // namespace event_queue
+
+#endif // THREAD_AFFINITY_HPP
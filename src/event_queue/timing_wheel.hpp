@@ -0,0 +1,426 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+/**
+ * @file timing_wheel.hpp
+ * @brief Declaration of TimingWheel, a hierarchical timing wheel for delayed and periodic events.
+ *
+ * A timing wheel hashes timers into buckets by expiry tick instead of keeping them sorted, so
+ * scheduling and cancelling a timer are O(1) regardless of how many are outstanding. Four
+ * levels of 256 buckets cover 2^32 ticks (about 49 days at the default 1 ms resolution);
+ * timers in the upper levels are cascaded down as time reaches their bucket. Timers are kept
+ * in a slab indexed by 32-bit handles, with the intrusive list links stored next to the
+ * callback, so there is no per-timer allocation once the slab has grown.
+ */
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace event_queue {
+
+/**
+ * @brief Identifies a scheduled timer.
+ *
+ * The generation counter makes stale handles harmless: once a timer has fired (one-shot) or
+ * been cancelled, its slot may be reused, but the old handle no longer matches it.
+ */
+struct TimerId {
+    std::uint32_t index = UINT32_MAX;   ///< Slot in the timer slab.
+    std::uint32_t generation = 0;       ///< Generation of the slot when the timer was created.
+
+    /**
+     * @brief Checks whether this handle was returned by a schedule call.
+     */
+    bool valid() const { return index != UINT32_MAX; }
+
+    friend bool operator==(const TimerId &, const TimerId &) = default;
+};
+
+/**
+ * @brief A hierarchical timing wheel holding callbacks of type @p Callback.
+ *
+ * The class is not thread-safe; EventQueue guards it with a mutex. Expired callbacks are moved
+ * out by advance() so that they can be run without holding that mutex. Periodic callbacks are
+ * handed back with rearm() after they have run.
+ *
+ * @tparam Callback A move-constructible, default-constructible callable type.
+ */
+template <typename Callback>
+class TimingWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A timer taken out of the wheel by advance().
+     */
+    struct Expired {
+        TimerId id;        ///< The timer's handle.
+        Callback callback; ///< The callback to run.
+        bool periodic;     ///< Whether the callback must be handed back with rearm().
+    };
+
+    /**
+     * @brief Constructs an empty wheel whose tick 0 is @p start.
+     *
+     * @param resolution The duration of one tick. Timers never fire early but may fire up to
+     *        one tick late.
+     * @param start The time corresponding to tick 0.
+     */
+    explicit TimingWheel(std::chrono::nanoseconds resolution = std::chrono::milliseconds(1),
+                         Clock::time_point start = Clock::now())
+        : resolution_(resolution.count() > 0 ? resolution : std::chrono::nanoseconds(1)),
+          start_(start) {
+        heads_.fill(kNil);
+        for (auto &level : occupied_) {
+            level.fill(0);
+        }
+    }
+
+    /**
+     * @brief Schedules @p callback to fire at @p when, and then every @p period if non-zero.
+     *
+     * @return A handle that can be passed to cancel().
+     */
+    TimerId schedule(Clock::time_point when, Callback &&callback,
+                     std::chrono::nanoseconds period = std::chrono::nanoseconds::zero()) {
+        const std::uint32_t index = allocateNode();
+        Node &node = nodes_[index];
+        node.callback = std::move(callback);
+        node.expiry = tickAtOrAfter(when);
+        node.period = period.count() > 0 ? ticksCeil(period) : 0;
+        node.cancelled = false;
+        insert(index);
+        ++size_;
+        return TimerId{index, node.generation};
+    }
+
+    /**
+     * @brief Cancels a timer in O(1).
+     *
+     * A periodic timer whose callback is currently running is cancelled as soon as it is
+     * handed back with rearm().
+     *
+     * @return true if the timer was pending (or running) and is now cancelled.
+     */
+    bool cancel(TimerId id) {
+        if (id.index >= nodes_.size()) {
+            return false;
+        }
+        Node &node = nodes_[id.index];
+        if (node.generation != id.generation || node.bucket == kFreeBucket || node.cancelled) {
+            return false;
+        }
+        if (node.bucket == kFiringBucket) {
+            node.cancelled = true;
+            return true;
+        }
+        unlink(id.index);
+        node.callback = Callback();
+        freeNode(id.index);
+        return true;
+    }
+
+    /**
+     * @brief Advances the wheel to @p now and moves every expired callback into @p out.
+     *
+     * One-shot timers are released immediately. Periodic timers stay reserved until their
+     * callback is handed back with rearm().
+     */
+    void advance(Clock::time_point now, std::vector<Expired> &out) {
+        fireBucket(kDueBucket, out);
+        const std::uint64_t target = tickAtOrBefore(now);
+        while (current_ < target) {
+            // Jump straight to the next occupied level-0 bucket or the next cascade point.
+            const std::uint64_t windowStart = current_ & ~kSlotMask;
+            const std::size_t nextSlot = nextOccupied(0, (current_ & kSlotMask) + 1);
+            const std::uint64_t step = nextSlot < kSlots ? windowStart + nextSlot : windowStart + kSlots;
+            if (step > target) {
+                current_ = target;
+                break;
+            }
+            current_ = step;
+            if ((current_ & kSlotMask) == 0) {
+                cascade();
+            }
+            fireBucket(bucketOf(0, current_ & kSlotMask), out);
+        }
+    }
+
+    /**
+     * @brief Hands back the callback of a periodic timer after it has run.
+     *
+     * The timer is rescheduled one period after its previous expiry (skipping periods that
+     * were missed entirely), unless it was cancelled while running.
+     */
+    void rearm(TimerId id, Callback &&callback) {
+        Node &node = nodes_[id.index];
+        if (node.cancelled) {
+            freeNode(id.index);
+            return;
+        }
+        node.callback = std::move(callback);
+        do {
+            node.expiry += node.period;
+        } while (node.expiry <= current_);
+        insert(id.index);
+    }
+
+    /**
+     * @brief Returns a lower bound for the next expiry, or std::nullopt if no timer is pending.
+     *
+     * The bound is exact for timers in the lowest level; for timers further out it is the
+     * time at which they are cascaded, which is never later than their expiry.
+     */
+    std::optional<Clock::time_point> nextExpiry() const {
+        if (heads_[kDueBucket] != kNil) {
+            return timeOfTick(current_);
+        }
+        std::optional<std::uint64_t> best;
+        for (std::size_t level = 0; level < kLevels; ++level) {
+            const unsigned shift = static_cast<unsigned>(level * kSlotBits);
+            const std::uint64_t index = (current_ >> shift) & kSlotMask;
+            const std::uint64_t revolution = (current_ >> shift) & ~kSlotMask;
+            std::size_t slot = nextOccupied(level, static_cast<std::size_t>(index) + 1);
+            std::uint64_t tick;
+            if (slot < kSlots) {
+                tick = (revolution + slot) << shift;
+            } else if ((slot = nextOccupied(level, 0)) < kSlots) {
+                tick = (revolution + kSlots + slot) << shift; // Wrapped into the next revolution.
+            } else {
+                continue;
+            }
+            if (!best || tick < *best) {
+                best = tick;
+            }
+        }
+        if (!best) {
+            return std::nullopt;
+        }
+        return timeOfTick(*best);
+    }
+
+    /**
+     * @brief Returns the number of pending timers (including periodic ones that are running).
+     */
+    std::size_t size() const { return size_; }
+
+private:
+    static constexpr std::uint32_t kNil = UINT32_MAX;
+    static constexpr std::size_t kSlotBits = 8;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    static constexpr std::size_t kLevels = 4;
+    static constexpr std::uint16_t kDueBucket = kLevels * kSlots;    ///< Timers already expired.
+    static constexpr std::uint16_t kFiringBucket = kDueBucket + 1;   ///< Periodic callback running.
+    static constexpr std::uint16_t kFreeBucket = kDueBucket + 2;     ///< Slot on the free list.
+
+    /**
+     * @brief A timer: its callback, its schedule and its intrusive list links.
+     */
+    struct Node {
+        Callback callback;
+        std::uint64_t expiry = 0;         ///< Expiry tick.
+        std::uint64_t period = 0;         ///< Period in ticks; zero for one-shot timers.
+        std::uint32_t prev = kNil;        ///< Previous node in the bucket (or kNil).
+        std::uint32_t next = kNil;        ///< Next node in the bucket, or on the free list.
+        std::uint32_t generation = 0;     ///< Incremented each time the slot is freed.
+        std::uint16_t bucket = kFreeBucket; ///< Bucket the node is linked into.
+        bool cancelled = false;           ///< Cancelled while its periodic callback was running.
+    };
+
+    static std::uint16_t bucketOf(std::size_t level, std::uint64_t slot) {
+        return static_cast<std::uint16_t>(level * kSlots + slot);
+    }
+
+    std::uint64_t ticksCeil(std::chrono::nanoseconds duration) const {
+        return static_cast<std::uint64_t>((duration.count() + resolution_.count() - 1) / resolution_.count());
+    }
+
+    std::uint64_t tickAtOrAfter(Clock::time_point when) const {
+        const auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(when - start_);
+        return offset.count() <= 0 ? 0 : ticksCeil(offset);
+    }
+
+    std::uint64_t tickAtOrBefore(Clock::time_point when) const {
+        const auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(when - start_);
+        return offset.count() <= 0 ? 0 : static_cast<std::uint64_t>(offset.count() / resolution_.count());
+    }
+
+    Clock::time_point timeOfTick(std::uint64_t tick) const {
+        return start_ + std::chrono::duration_cast<Clock::duration>(
+                            resolution_ * static_cast<std::int64_t>(tick));
+    }
+
+    std::uint32_t allocateNode() {
+        if (freeList_ != kNil) {
+            const std::uint32_t index = freeList_;
+            freeList_ = nodes_[index].next;
+            return index;
+        }
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void freeNode(std::uint32_t index) {
+        Node &node = nodes_[index];
+        ++node.generation;
+        node.bucket = kFreeBucket;
+        node.cancelled = false;
+        node.prev = kNil;
+        node.next = freeList_;
+        freeList_ = index;
+        --size_;
+    }
+
+    /**
+     * @brief Links a node into the bucket matching its expiry relative to the current tick.
+     */
+    void insert(std::uint32_t index) {
+        Node &node = nodes_[index];
+        std::uint16_t bucket;
+        if (node.expiry <= current_) {
+            // The bucket of the current tick has already been fired (or is being cascaded into).
+            bucket = kDueBucket;
+        } else {
+            const std::uint64_t delta = node.expiry - current_;
+            std::size_t level = 0;
+            while (level + 1 < kLevels && delta >= (std::uint64_t{1} << ((level + 1) * kSlotBits))) {
+                ++level;
+            }
+            // Timers beyond the top level's range are parked at its far end and cascaded again.
+            const std::uint64_t horizon = current_ + (std::uint64_t{1} << (kLevels * kSlotBits)) - 1;
+            const std::uint64_t expiry = node.expiry < horizon ? node.expiry : horizon;
+            bucket = bucketOf(level, (expiry >> (level * kSlotBits)) & kSlotMask);
+        }
+        node.bucket = bucket;
+        node.prev = kNil;
+        node.next = heads_[bucket];
+        if (node.next != kNil) {
+            nodes_[node.next].prev = index;
+        }
+        heads_[bucket] = index;
+        markOccupied(bucket);
+    }
+
+    void unlink(std::uint32_t index) {
+        Node &node = nodes_[index];
+        if (node.prev != kNil) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            heads_[node.bucket] = node.next;
+            if (node.next == kNil) {
+                markEmpty(node.bucket);
+            }
+        }
+        if (node.next != kNil) {
+            nodes_[node.next].prev = node.prev;
+        }
+        node.prev = node.next = kNil;
+    }
+
+    /**
+     * @brief Detaches a whole bucket and returns the first node of its list.
+     */
+    std::uint32_t takeBucket(std::uint16_t bucket) {
+        const std::uint32_t head = heads_[bucket];
+        heads_[bucket] = kNil;
+        markEmpty(bucket);
+        return head;
+    }
+
+    void fireBucket(std::uint16_t bucket, std::vector<Expired> &out) {
+        for (std::uint32_t index = takeBucket(bucket); index != kNil;) {
+            Node &node = nodes_[index];
+            const std::uint32_t next = node.next;
+            const TimerId id{index, node.generation};
+            const bool periodic = node.period != 0;
+            out.push_back(Expired{id, std::move(node.callback), periodic});
+            if (periodic) {
+                node.bucket = kFiringBucket;
+                node.prev = node.next = kNil;
+            } else {
+                freeNode(index);
+            }
+            index = next;
+        }
+    }
+
+    /**
+     * @brief Re-inserts the buckets of the upper levels whose window starts at the current tick.
+     */
+    void cascade() {
+        for (std::size_t level = 1; level < kLevels; ++level) {
+            const std::uint64_t slot = (current_ >> (level * kSlotBits)) & kSlotMask;
+            for (std::uint32_t index = takeBucket(bucketOf(level, slot)); index != kNil;) {
+                const std::uint32_t next = nodes_[index].next;
+                insert(index);
+                index = next;
+            }
+            if (slot != 0) {
+                break;
+            }
+        }
+        // Timers cascaded onto the current tick land in the level-0 bucket fired next.
+        for (std::uint32_t index = takeBucket(kDueBucket); index != kNil;) {
+            const std::uint32_t next = nodes_[index].next;
+            Node &node = nodes_[index];
+            const std::uint16_t bucket = bucketOf(0, current_ & kSlotMask);
+            node.bucket = bucket;
+            node.prev = kNil;
+            node.next = heads_[bucket];
+            if (node.next != kNil) {
+                nodes_[node.next].prev = index;
+            }
+            heads_[bucket] = index;
+            markOccupied(bucket);
+            index = next;
+        }
+    }
+
+    void markOccupied(std::uint16_t bucket) {
+        if (bucket < kDueBucket) {
+            occupied_[bucket / kSlots][(bucket % kSlots) / 64] |= std::uint64_t{1} << (bucket % 64);
+        }
+    }
+
+    void markEmpty(std::uint16_t bucket) {
+        if (bucket < kDueBucket) {
+            occupied_[bucket / kSlots][(bucket % kSlots) / 64] &= ~(std::uint64_t{1} << (bucket % 64));
+        }
+    }
+
+    /**
+     * @brief Returns the first occupied slot of @p level at or after @p from, or kSlots.
+     */
+    std::size_t nextOccupied(std::size_t level, std::size_t from) const {
+        for (std::size_t word = from / 64; word < kSlots / 64; ++word) {
+            std::uint64_t bits = occupied_[level][word];
+            if (word == from / 64) {
+                bits &= ~std::uint64_t{0} << (from % 64);
+            }
+            if (bits != 0) {
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+        }
+        return kSlots;
+    }
+
+    std::chrono::nanoseconds resolution_;  ///< Duration of one tick.
+    Clock::time_point start_;              ///< Time of tick 0.
+    std::uint64_t current_ = 0;            ///< The last tick processed by advance().
+    std::vector<Node> nodes_;              ///< Timer slab.
+    std::uint32_t freeList_ = kNil;        ///< First free slab slot.
+    std::size_t size_ = 0;                 ///< Number of timers not on the free list.
+    std::array<std::uint32_t, kDueBucket + 1> heads_; ///< Bucket list heads (wheel buckets + due list).
+    std::array<std::array<std::uint64_t, kSlots / 64>, kLevels> occupied_; ///< Non-empty bucket bitmaps.
+};
+
+} // namespace event_queue
+
+#endif // TIMING_WHEEL_HPP
@@ -0,0 +1,157 @@
+#ifndef TYPED_EVENT_QUEUE_HPP
+#define TYPED_EVENT_QUEUE_HPP
+
+/**
+ * @file typed_event_queue.hpp
+ * @brief Declaration of TypedEventQueue, an event queue over a closed set of event structs.
+ *
+ * EventQueue stores type-erased callables, so every dispatch is an indirect call the compiler
+ * cannot see through, and queued events cannot be told apart. When the set of event kinds is
+ * known up front, TypedEventQueue stores plain event structs in a std::variant instead. The
+ * events sit contiguously in a std::vector and are dispatched with std::visit to a visitor whose
+ * call operators the compiler can inline.
+ */
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace event_queue {
+
+/**
+ * @brief Builds a visitor out of several lambdas, one per event type.
+ *
+ * @code
+ * queue.processEvents(Overloaded{
+ *     [](const KeyPressed &event) { ... },
+ *     [](const MouseMoved &event) { ... },
+ * });
+ * @endcode
+ */
+template <typename... Handlers>
+struct Overloaded : Handlers... {
+    using Handlers::operator()...;
+};
+
+template <typename... Handlers>
+Overloaded(Handlers...) -> Overloaded<Handlers...>;
+
+/**
+ * @brief A thread-safe FIFO queue of events drawn from a fixed set of types.
+ *
+ * Producers push event structs from any thread; processEvents() swaps the pending events out
+ * under a single lock acquisition and dispatches them to a visitor without holding the lock.
+ * Both the pending and the in-flight buffers keep their capacity across drains, so the steady
+ * state does not allocate.
+ *
+ * @tparam Events The event types. Each must be move-constructible.
+ */
+template <typename... Events>
+class TypedEventQueue {
+public:
+    /**
+     * @brief The stored representation of an event: one of @p Events.
+     */
+    using Event = std::variant<Events...>;
+
+    /**
+     * @brief Whether @p E is one of the queue's event types.
+     */
+    template <typename E>
+    static constexpr bool holds = (std::is_same_v<std::decay_t<E>, Events> || ...);
+
+    TypedEventQueue() = default;
+    TypedEventQueue(const TypedEventQueue &) = delete;
+    TypedEventQueue &operator=(const TypedEventQueue &) = delete;
+
+    /**
+     * @brief Enqueues an event.
+     *
+     * @param event The event, copied or moved into the queue.
+     */
+    template <typename E>
+        requires holds<E>
+    void pushEvent(E &&event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.emplace_back(std::in_place_type<std::decay_t<E>>, std::forward<E>(event));
+    }
+
+    /**
+     * @brief Constructs an event of type @p E directly in the queue.
+     *
+     * @param args The arguments forwarded to the constructor of @p E.
+     */
+    template <typename E, typename... Args>
+        requires holds<E>
+    void emplaceEvent(Args &&...args) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.emplace_back(std::in_place_type<E>, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Dispatches every pending event to @p visitor in FIFO order.
+     *
+     * Events pushed while the batch runs, including by the visitor itself, are left for the
+     * next call.
+     *
+     * @param visitor A callable accepting every event type (see Overloaded).
+     * @return The number of events dispatched.
+     */
+    template <typename Visitor>
+    std::size_t processEvents(Visitor &&visitor) {
+        std::vector<Event> batch;
+        {
+            // Take the recycled buffer and exchange it with the pending events in one go.
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(spare_);
+            batch.swap(pending_);
+        }
+        for (Event &event : batch) {
+            std::visit(visitor, event);
+        }
+        const std::size_t count = batch.size();
+        batch.clear();
+        // Hand the (now empty) storage back so the next drain reuses its capacity.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (batch.capacity() > spare_.capacity()) {
+            spare_.swap(batch);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Reserves room for @p count pending events, so pushes up to that depth never allocate.
+     */
+    void reserve(std::size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.reserve(count);
+        spare_.reserve(count);
+    }
+
+    /**
+     * @brief Returns the number of pending events.
+     */
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+    /**
+     * @brief Checks whether the queue has no pending events.
+     */
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+private:
+    mutable std::mutex mutex_;   ///< Protects pending_ and spare_.
+    std::vector<Event> pending_; ///< Events waiting for the next processEvents() call.
+    std::vector<Event> spare_;   ///< Recycled storage for the next batch.
+};
+
+} // namespace event_queue
+
+#endif // TYPED_EVENT_QUEUE_HPP
@@ -0,0 +1,409 @@
+/**
+ * @file concurrent_subject.hpp
+ * @brief Declaration of the BasicConcurrentSubject class, a thread-safe subject with lock-free notify().
+ *
+ * The observer list is an immutable snapshot published through an atomic pointer. addObserver()
+ * and removeObserver() copy the current snapshot, change the copy and swap it in; notify() loads
+ * the current snapshot and walks it without taking a lock. Retired snapshots are reclaimed with
+ * epoch-based reclamation (a simple form of RCU): a reader announces the epoch it started in, in
+ * a slot owned by its thread, and a snapshot is freed once every thread that could still see it
+ * has left its notify() call.
+ */
+
+#ifndef CONCURRENT_SUBJECT_HPP
+#define CONCURRENT_SUBJECT_HPP
+
+#include "observer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace observer {
+
+namespace detail {
+
+/**
+ * @brief Process-wide epoch-based reclamation domain shared by all ConcurrentSubjects.
+ *
+ * Every thread that enters a read section gets a Record of its own, on its own cache line, and
+ * writes only to that record. A read section is announced together with the subject it reads,
+ * so a writer waits only for readers of its own subject: a slow observer of one subject does not
+ * hold up removeObserver() on another. Writers advance the global epoch after they unpublish a
+ * snapshot; the snapshot may be freed once no reader of its subject still shows an epoch from
+ * before that point.
+ */
+class EpochDomain {
+public:
+    static constexpr unsigned kTrackedDepth = 4; ///< Nested read sections announced per subject.
+
+    /**
+     * @brief Per-thread reader state.
+     *
+     * Slot i describes the i-th nested read section of the owning thread. Sections nested deeper
+     * than kTrackedDepth are announced through @c overflowEpoch, which writers of every subject
+     * treat as a reader of theirs.
+     */
+    struct alignas(64) Record {
+        std::atomic<const void *> owner[kTrackedDepth] = {}; ///< Subject read by each nested section.
+        std::atomic<std::uint64_t> epoch[kTrackedDepth] = {}; ///< Epoch each section started in; 0 when unused.
+        std::atomic<std::uint64_t> overflowEpoch{0};          ///< Epoch of the first untracked section, or 0.
+        std::atomic<bool> inUse{true};                        ///< False once the owning thread has exited.
+        Record *next = nullptr;  ///< Next record in the domain's list (never changes once linked).
+        unsigned nesting = 0;    ///< Depth of nested read sections (owner thread only).
+        std::vector<std::pair<const void *, std::uint64_t>> deferred; ///< Waits postponed to the outermost leave().
+    };
+
+    /**
+     * @brief Returns the domain.
+     */
+    static EpochDomain &instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /**
+     * @brief Returns the calling thread's record, claiming one on first use.
+     */
+    Record &record() {
+        thread_local Holder holder(*this);
+        return *holder.record;
+    }
+
+    /**
+     * @brief Starts a read section of @p owner on the calling thread.
+     */
+    void enter(Record &record, const void *owner) {
+        const unsigned depth = record.nesting++;
+        const std::uint64_t epoch = epoch_.load(std::memory_order_acquire);
+        if (depth < kTrackedDepth) {
+            record.owner[depth].store(owner, std::memory_order_relaxed);
+            record.epoch[depth].store(epoch, std::memory_order_release);
+        } else if (depth == kTrackedDepth) {
+            record.overflowEpoch.store(epoch, std::memory_order_release);
+        } else {
+            return; // Covered by the overflow announcement.
+        }
+        // Publish the announcement before the snapshot pointer is read.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Ends a read section on the calling thread.
+     *
+     * When the outermost section ends, runs the waits removeObserver() postponed while the thread
+     * was reading; by then the thread announces nothing, so no two threads can wait for each other.
+     */
+    void leave(Record &record) {
+        const unsigned depth = --record.nesting;
+        if (depth < kTrackedDepth) {
+            record.epoch[depth].store(0, std::memory_order_release);
+        } else if (depth == kTrackedDepth) {
+            record.overflowEpoch.store(0, std::memory_order_release);
+        }
+        if (depth == 0 && !record.deferred.empty()) {
+            std::vector<std::pair<const void *, std::uint64_t>> deferred;
+            deferred.swap(record.deferred);
+            for (const auto &[owner, epoch] : deferred) {
+                waitForReaders(owner, epoch);
+            }
+        }
+    }
+
+    /**
+     * @brief Advances the epoch after a snapshot was unpublished.
+     *
+     * @return The epoch that readers of the unpublished snapshot may still show.
+     */
+    std::uint64_t advance() {
+        const std::uint64_t retired = epoch_.fetch_add(1, std::memory_order_acq_rel);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return retired;
+    }
+
+    /**
+     * @brief Returns true if no read section of @p owner that started in @p epoch or earlier is still running.
+     */
+    bool quiescentSince(const void *owner, std::uint64_t epoch) const {
+        const auto stale = [epoch](std::uint64_t seen) { return seen != 0 && seen <= epoch; };
+        for (const Record *record = records_.load(std::memory_order_acquire); record; record = record->next) {
+            if (!record->inUse.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (stale(record->overflowEpoch.load(std::memory_order_acquire))) {
+                return false;
+            }
+            for (unsigned depth = 0; depth < kTrackedDepth; ++depth) {
+                // A slot reused since the load below belongs to a section that started after ours ended.
+                if (stale(record->epoch[depth].load(std::memory_order_acquire)) &&
+                    record->owner[depth].load(std::memory_order_relaxed) == owner) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Blocks until quiescentSince(@p owner, @p epoch) holds.
+     */
+    void waitForReaders(const void *owner, std::uint64_t epoch) const {
+        while (!quiescentSince(owner, epoch)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Waits for the readers of @p owner up to @p epoch, or, if the calling thread is itself
+     * inside a read section, postpones the wait until its outermost section ends.
+     *
+     * Waiting from inside a read section could deadlock: two threads, each inside a notification,
+     * would each wait for the other to leave.
+     *
+     * @return True if the wait ran, false if it was postponed.
+     */
+    bool synchronize(const void *owner, std::uint64_t epoch) {
+        Record &self = record();
+        if (self.nesting > 0) {
+            self.deferred.emplace_back(owner, epoch);
+            return false;
+        }
+        waitForReaders(owner, epoch);
+        return true;
+    }
+
+private:
+    /**
+     * @brief Owns the calling thread's claim on a record, and releases it when the thread exits.
+     *
+     * Records are never freed: an exited thread's record is reused by a later thread, so the list
+     * is as long as the largest number of threads that have been readers at the same time.
+     */
+    struct Holder {
+        explicit Holder(EpochDomain &domain) : record(domain.acquire()) {}
+        ~Holder() {
+            for (auto &epoch : record->epoch) {
+                epoch.store(0, std::memory_order_release);
+            }
+            record->overflowEpoch.store(0, std::memory_order_release);
+            record->inUse.store(false, std::memory_order_release);
+        }
+        Record *record;
+    };
+
+    EpochDomain() = default;
+
+    Record *acquire() {
+        for (Record *record = records_.load(std::memory_order_acquire); record; record = record->next) {
+            bool expected = false;
+            if (!record->inUse.load(std::memory_order_relaxed) &&
+                record->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return record;
+            }
+        }
+        auto *record = new Record;
+        record->next = records_.load(std::memory_order_relaxed);
+        while (!records_.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+        }
+        return record;
+    }
+
+    std::atomic<std::uint64_t> epoch_{1};      ///< Current epoch; 0 is reserved for "quiescent".
+    std::atomic<Record *> records_{nullptr};   ///< Every record ever claimed, newest first.
+};
+
+} // namespace detail
+
+/**
+ * @brief A Subject that can be notified from several threads while observers come and go.
+ *
+ * notify() takes no lock and writes only to the calling thread's reclamation record, so
+ * concurrent notifications neither serialize nor slow down as the subscription rate goes up.
+ * addObserver() and removeObserver() are serialized by a mutex and copy the observer list, so
+ * they cost O(n) each; this suits lists that are read far more often than they change.
+ *
+ * Once removeObserver() returns, no notification still running on another thread can reach the
+ * removed observer, so it may be destroyed. removeObserver() called from inside onNotify() (of
+ * this subject or any other ConcurrentSubject) cannot wait for other readers without risking a
+ * deadlock, so it returns at once and the wait runs when the calling thread's outermost notify()
+ * returns; only from then on may the removed observer be destroyed. A notification running on
+ * the calling thread still completes with the snapshot it started with.
+ *
+ * @tparam Event The type of the events, passed to the observers by reference.
+ */
+template <typename Event>
+class BasicConcurrentSubject {
+public:
+    using EventType = Event;                   ///< The type of the events.
+    using ObserverType = BasicObserver<Event>; ///< The observers this subject notifies.
+
+    BasicConcurrentSubject() : current_(new Snapshot) {}
+
+    /**
+     * @brief Destroys the subject. No notify() may be running.
+     */
+    ~BasicConcurrentSubject() {
+        delete current_.load(std::memory_order_relaxed);
+        for (const Retired &retired : retired_) {
+            delete retired.snapshot;
+        }
+    }
+
+    BasicConcurrentSubject(const BasicConcurrentSubject &) = delete;
+    BasicConcurrentSubject &operator=(const BasicConcurrentSubject &) = delete;
+
+    /**
+     * @brief Adds an observer to the list of observers.
+     *
+     * @param observer A pointer to an object implementing the BasicObserver interface.
+     */
+    void addObserver(ObserverType *observer) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        auto next = std::make_unique<Snapshot>(*current_.load(std::memory_order_relaxed));
+        next->observers.push_back(observer);
+        publish(std::move(next));
+    }
+
+    /**
+     * @brief Removes an observer from the list, waiting for notifications that may still reach it.
+     *
+     * Called from inside a notification, the wait is postponed until the calling thread's
+     * outermost notify() returns (see the class description).
+     *
+     * @param observer A pointer to the observer to remove.
+     */
+    void removeObserver(ObserverType *observer) {
+        std::uint64_t epoch = 0;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            const Snapshot *current = current_.load(std::memory_order_relaxed);
+            if (std::find(current->observers.begin(), current->observers.end(), observer) ==
+                current->observers.end()) {
+                return;
+            }
+            auto next = std::make_unique<Snapshot>(*current);
+            next->observers.erase(std::remove(next->observers.begin(), next->observers.end(), observer),
+                                  next->observers.end());
+            epoch = publish(std::move(next));
+        }
+        // Wait without the lock: a running observer may itself be adding or removing observers.
+        if (domain_.synchronize(this, epoch)) {
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            reclaim();
+        }
+    }
+
+    /**
+     * @brief Notifies all registered observers of an event.
+     *
+     * Observers added or removed during the call may or may not be notified by it.
+     *
+     * @param event The event, e.g. a string describing it.
+     */
+    void notify(const Event &event) const {
+        ReadSection section(domain_, this);
+        for (ObserverType *observer : current_.load(std::memory_order_acquire)->observers) {
+            if (observer) {
+                observer->onNotify(event);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of registered observers.
+     */
+    std::size_t observerCount() const {
+        ReadSection section(domain_, this);
+        return current_.load(std::memory_order_acquire)->observers.size();
+    }
+
+    /**
+     * @brief Returns the number of retired snapshots still waiting for readers to finish.
+     */
+    std::size_t retiredSnapshots() const {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return retired_.size();
+    }
+
+private:
+    /**
+     * @brief An immutable observer list.
+     */
+    struct Snapshot {
+        std::vector<ObserverType *> observers; ///< Registered observers, in registration order.
+    };
+
+    /**
+     * @brief A snapshot that has been replaced, with the epoch its last readers may show.
+     */
+    struct Retired {
+        const Snapshot *snapshot;
+        std::uint64_t epoch;
+    };
+
+    /**
+     * @brief Marks the calling thread as reading for the lifetime of the object.
+     */
+    class ReadSection {
+    public:
+        ReadSection(detail::EpochDomain &domain, const void *owner) : domain_(domain), record_(domain.record()) {
+            domain_.enter(record_, owner);
+        }
+        ~ReadSection() { domain_.leave(record_); }
+        ReadSection(const ReadSection &) = delete;
+        ReadSection &operator=(const ReadSection &) = delete;
+
+    private:
+        detail::EpochDomain &domain_;
+        detail::EpochDomain::Record &record_;
+    };
+
+    /**
+     * @brief Swaps in @p next and retires the previous snapshot. Requires writeMutex_.
+     *
+     * @return The epoch the retired snapshot's readers may show.
+     */
+    std::uint64_t publish(std::unique_ptr<Snapshot> next) {
+        const Snapshot *previous = current_.exchange(next.release(), std::memory_order_acq_rel);
+        const std::uint64_t epoch = domain_.advance();
+        retired_.push_back(Retired{previous, epoch});
+        reclaim();
+        return epoch;
+    }
+
+    /**
+     * @brief Frees the retired snapshots no reader can still see. Requires writeMutex_.
+     */
+    void reclaim() {
+        auto keep = retired_.begin();
+        for (const Retired &retired : retired_) {
+            if (domain_.quiescentSince(this, retired.epoch)) {
+                delete retired.snapshot;
+            } else {
+                *keep++ = retired;
+            }
+        }
+        retired_.erase(keep, retired_.end());
+    }
+
+    std::atomic<const Snapshot *> current_;                          ///< The published observer list.
+    std::vector<Retired> retired_;                                   ///< Replaced snapshots not yet freed.
+    mutable std::mutex writeMutex_;                                  ///< Serializes writers.
+    detail::EpochDomain &domain_ = detail::EpochDomain::instance(); ///< Reclamation domain.
+};
+
+/**
+ * @brief A concurrent subject whose events are string messages.
+ */
+using ConcurrentSubject = BasicConcurrentSubject<std::string>;
+
+} // namespace observer
+
+#endif // CONCURRENT_SUBJECT_HPP
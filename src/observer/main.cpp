@@ -39,16 +39,16 @@ int main() {
     ConcreteObserver observer1;
     ConcreteObserver observer2;
 
-    // Register observers with the subject.
-    subject.addObserver(&observer1);
-    subject.addObserver(&observer2);
+    // Register observers with the subject. Each stays registered while its subscription lives.
+    Subscription subscription1 = subject.addObserver(&observer1);
+    Subscription subscription2 = subject.addObserver(&observer2);
 
     // Notify all observers with an event.
     std::cout << "Notifying observers (first time):" << std::endl;
     subject.notify("Event 1: Something happened!");
 
-    // Remove one observer.
-    subject.removeObserver(&observer1);
+    // Remove one observer by ending its subscription.
+    subscription1.unsubscribe();
 
     // Notify the remaining observers.
     std::cout << "Notifying observers (second time):" << std::endl;
@@ -1,9 +1,10 @@
 /**
  * @file observer.hpp
- * @brief Declaration of the IObserver interface for the Observer pattern.
+ * @brief Declaration of the BasicObserver and IObserver interfaces for the Observer pattern.
  *
- * This file declares the IObserver interface which defines the contract that
- * all observers must implement in order to receive event notifications from a Subject.
+ * This file declares the BasicObserver interface which defines the contract that
+ * all observers must implement in order to receive event notifications from a Subject,
+ * and IObserver, its instantiation for string messages.
  */
 
 #ifndef OBSERVER_HPP
@@ -16,9 +17,10 @@
  * @brief Implements the Observer design pattern for event notifications.
  *
  * This namespace provides the fundamental components for implementing the Observer design pattern.
- * It defines the IObserver interface, which declares the callback method that must be implemented
- * by any class that wishes to receive event notifications, and the Subject class, which maintains
- * a list of observers and dispatches events to them.
+ * It defines the BasicObserver interface, which declares the callback method that must be implemented
+ * by any class that wishes to receive event notifications, and the BasicSubject class, which maintains
+ * a list of observers and dispatches events to them. IObserver and Subject are their instantiations
+ * for string messages.
  *
  * The Observer pattern facilitates a decoupled design where the subject does not need to know the
  * specifics of its observers. This results in a more modular and maintainable system, especially
@@ -29,17 +31,24 @@ namespace observer {
 /**
  * @brief Interface for observer objects.
  *
- * The IObserver interface declares the onNotify() method that must be implemented
- * by any class that wishes to be notified of events by a Subject.
+ * The BasicObserver interface declares the onNotify() method that must be implemented
+ * by any class that wishes to be notified of events by a BasicSubject with the same
+ * event type. Events are passed by reference, so a structured event (a struct or a
+ * std::variant of structs) reaches every observer without being formatted or copied.
+ *
+ * @tparam Event The type of the events.
  */
-class IObserver {
+template <typename Event>
+class BasicObserver {
 public:
+    using EventType = Event; ///< The type of the events this observer receives.
+
     /**
      * @brief Virtual destructor.
      *
      * Ensures that derived classes are properly destroyed.
      */
-    virtual ~IObserver() = default;
+    virtual ~BasicObserver() = default;
 
     /**
      * @brief Notifies the observer of an event.
@@ -47,11 +56,19 @@ public:
      * This pure virtual function must be overridden by derived classes to handle
      * event notifications.
      *
-     * @param message A string containing details about the event.
+     * @param event The event, valid for the duration of the call.
      */
-    virtual void onNotify(const std::string &message) = 0;
+    virtual void onNotify(const Event &event) = 0;
 };
 
+/**
+ * @brief Interface for observers of string messages.
+ *
+ * Derived classes override onNotify(const std::string &message), where the message
+ * contains details about the event.
+ */
+using IObserver = BasicObserver<std::string>;
+
 } // namespace observer
 
 #endif // OBSERVER_HPP
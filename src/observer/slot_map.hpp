@@ -0,0 +1,178 @@
+/**
+ * @file slot_map.hpp
+ * @brief Declaration of the SlotMap container, a dense array addressed by generational keys.
+ *
+ * A SlotMap stores its values contiguously and hands out a SlotKey for each one. Insertion,
+ * lookup and erasure by key are O(1): erasure moves the last value into the hole, and an
+ * indirection table maps keys to the current position of their value. Each slot carries a
+ * generation that is bumped when its value is erased, so a key to an erased value never finds
+ * the value that later reuses the slot.
+ */
+
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace observer {
+
+/**
+ * @brief Identifies one value in a SlotMap.
+ *
+ * A default-constructed key refers to nothing.
+ */
+struct SlotKey {
+    static constexpr std::uint32_t kInvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t index = kInvalidIndex; ///< Slot in the indirection table.
+    std::uint32_t generation = 0;        ///< Generation of the slot when the key was issued.
+
+    friend bool operator==(const SlotKey &, const SlotKey &) = default;
+};
+
+/**
+ * @brief A container of values kept in dense order and addressed by generational keys.
+ *
+ * Iteration visits the values contiguously, in no particular order: erasing a value moves the
+ * last value into its place. Pointers and iterators are invalidated by insert() and erase(),
+ * keys only by erasing their own value.
+ *
+ * @tparam T The value type. It must be move-assignable.
+ */
+template <typename T>
+class SlotMap {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /**
+     * @brief Adds a value and returns its key.
+     *
+     * @throws std::length_error if the map already holds 2^32 - 1 slots.
+     */
+    SlotKey insert(T value) {
+        std::uint32_t index = freeHead_;
+        if (index == SlotKey::kInvalidIndex) {
+            if (slots_.size() >= SlotKey::kInvalidIndex) {
+                throw std::length_error("SlotMap is full");
+            }
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back(Slot{});
+        } else {
+            freeHead_ = slots_[index].position;
+        }
+        values_.push_back(std::move(value));
+        owners_.push_back(index);
+        slots_[index].position = static_cast<std::uint32_t>(values_.size() - 1);
+        return SlotKey{index, slots_[index].generation};
+    }
+
+    /**
+     * @brief Removes the value of @p key.
+     *
+     * @return false if @p key does not refer to a value of this map.
+     */
+    bool erase(SlotKey key) {
+        if (!contains(key)) {
+            return false;
+        }
+        Slot &slot = slots_[key.index];
+        const std::uint32_t position = slot.position;
+        const std::uint32_t last = static_cast<std::uint32_t>(values_.size() - 1);
+        if (position != last) {
+            values_[position] = std::move(values_[last]);
+            owners_[position] = owners_[last];
+            slots_[owners_[position]].position = position;
+        }
+        values_.pop_back();
+        owners_.pop_back();
+        ++slot.generation;
+        slot.position = freeHead_;
+        freeHead_ = key.index;
+        return true;
+    }
+
+    /**
+     * @brief Returns true if @p key refers to a value of this map.
+     */
+    bool contains(SlotKey key) const {
+        return key.index < slots_.size() && slots_[key.index].generation == key.generation;
+    }
+
+    /**
+     * @brief Returns the value of @p key, or nullptr if the key is stale.
+     */
+    T *find(SlotKey key) { return contains(key) ? &values_[slots_[key.index].position] : nullptr; }
+
+    /**
+     * @brief Returns the value of @p key, or nullptr if the key is stale.
+     */
+    const T *find(SlotKey key) const { return contains(key) ? &values_[slots_[key.index].position] : nullptr; }
+
+    /**
+     * @brief Returns the value at dense position @p position (0 <= position < size()).
+     */
+    T &operator[](std::size_t position) { return values_[position]; }
+
+    /**
+     * @brief Returns the value at dense position @p position (0 <= position < size()).
+     */
+    const T &operator[](std::size_t position) const { return values_[position]; }
+
+    /**
+     * @brief Returns the key of the value at dense position @p position.
+     */
+    SlotKey keyAt(std::size_t position) const {
+        const std::uint32_t index = owners_[position];
+        return SlotKey{index, slots_[index].generation};
+    }
+
+    /**
+     * @brief Reserves room for @p count values.
+     */
+    void reserve(std::size_t count) {
+        values_.reserve(count);
+        owners_.reserve(count);
+        slots_.reserve(count);
+    }
+
+    /**
+     * @brief Removes every value. Every outstanding key becomes stale.
+     */
+    void clear() {
+        while (!values_.empty()) {
+            erase(keyAt(values_.size() - 1));
+        }
+    }
+
+    std::size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    iterator begin() { return values_.begin(); }
+    iterator end() { return values_.end(); }
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+
+private:
+    /**
+     * @brief One entry of the indirection table.
+     */
+    struct Slot {
+        std::uint32_t position = 0;   ///< Dense position of the value; next free slot when free.
+        std::uint32_t generation = 0; ///< Bumped whenever the slot's value is erased.
+    };
+
+    std::vector<T> values_;                         ///< The values, contiguous.
+    std::vector<std::uint32_t> owners_;             ///< Slot of each dense value.
+    std::vector<Slot> slots_;                       ///< Indirection table indexed by SlotKey::index.
+    std::uint32_t freeHead_ = SlotKey::kInvalidIndex; ///< First free slot, linked through Slot::position.
+};
+
+} // namespace observer
+
+#endif // SLOT_MAP_HPP
@@ -1,70 +1,404 @@
 /**
  * @file subject.hpp
- * @brief Declaration of the Subject class for the Observer pattern.
+ * @brief Declaration of the BasicSubject and Subject classes for the Observer pattern.
  *
- * This file declares the Subject class, which maintains a list of observers and
- * notifies them about events. Observers can be added or removed dynamically.
+ * This file declares the BasicSubject class template, which maintains a list of observers and
+ * notifies them about events of a given type, its instantiation Subject for string messages,
+ * and the Subscription handle that keeps an observer registered for as long as the handle
+ * lives. Observers can be added or removed dynamically.
  */
 
 #ifndef SUBJECT_HPP
 #define SUBJECT_HPP
 
 #include "observer.hpp"
-#include <vector>
+#include "slot_map.hpp"
 #include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace observer {
 
+namespace detail {
+
+/**
+ * @brief The part of a subject's observer storage that a Subscription needs.
+ *
+ * It hides the event type, so that one Subscription type serves subjects of every event type.
+ */
+class SubscriptionTarget {
+public:
+    virtual ~SubscriptionTarget() = default;
+
+    /**
+     * @brief Returns true if @p key refers to an observer that has not been removed.
+     */
+    virtual bool contains(SlotKey key) const = 0;
+
+    /**
+     * @brief Removes the observer of @p key.
+     */
+    virtual void remove(SlotKey key) = 0;
+};
+
+/**
+ * @brief The observer storage of a BasicSubject, shared with its Subscriptions.
+ *
+ * Observers live in a SlotMap, so notify() walks a contiguous array and a Subscription removes
+ * its observer in O(1). A removal during notify() only clears the entry, so that the dense
+ * order the notification is walking does not change; cleared entries are erased when the
+ * outermost notify() returns.
+ */
+template <typename Event>
+class ObserverRegistry final : public SubscriptionTarget {
+public:
+    SlotMap<BasicObserver<Event> *> observers; ///< Registered observers; nullptr marks a deferred removal.
+    std::vector<SlotKey> deferred;             ///< Keys removed while a notification was running.
+    unsigned notifying = 0;                    ///< Depth of running notify() calls.
+
+    bool contains(SlotKey key) const override {
+        BasicObserver<Event> *const *observer = observers.find(key);
+        return observer && *observer;
+    }
+
+    /**
+     * @brief Removes the observer of @p key, or defers the removal while notifying.
+     */
+    void remove(SlotKey key) override {
+        if (notifying == 0) {
+            observers.erase(key);
+        } else if (BasicObserver<Event> **observer = observers.find(key); observer && *observer) {
+            *observer = nullptr;
+            deferred.push_back(key);
+        }
+    }
+
+    /**
+     * @brief Erases the entries whose removal was deferred.
+     */
+    void compact() {
+        for (SlotKey key : deferred) {
+            observers.erase(key);
+        }
+        deferred.clear();
+    }
+};
+
+/**
+ * @brief The state of one BasicSubject::notifyParallel() call, shared by its chunks.
+ */
+template <typename Event>
+struct ParallelNotification {
+    ParallelNotification(const Event &event, std::vector<BasicObserver<Event> *> observers, std::size_t chunkSize)
+        : event(event), observers(std::move(observers)), chunkSize(chunkSize),
+          remaining((this->observers.size() + chunkSize - 1) / chunkSize) {}
+
+    /**
+     * @brief Notifies the observers of chunk @p chunk; the last chunk to finish completes the future.
+     */
+    void run(std::size_t chunk) {
+        const std::size_t end = std::min(observers.size(), (chunk + 1) * chunkSize);
+        try {
+            for (std::size_t i = chunk * chunkSize; i < end; ++i) {
+                observers[i]->onNotify(event);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (error) {
+                done.set_exception(error);
+            } else {
+                done.set_value();
+            }
+        }
+    }
+
+    const Event event;                                   ///< Copy of the event, alive until every chunk ran.
+    const std::vector<BasicObserver<Event> *> observers; ///< The observers registered at the call.
+    const std::size_t chunkSize;                         ///< Observers per chunk.
+    std::atomic<std::size_t> remaining;                  ///< Chunks that have not finished yet.
+    std::promise<void> done;                             ///< Completed by the last chunk.
+    std::mutex errorMutex;                               ///< Protects error.
+    std::exception_ptr error;                            ///< First exception thrown by an observer.
+};
+
+} // namespace detail
+
+/**
+ * @brief A worker pool that BasicSubject::notifyParallel() can run chunks on.
+ *
+ * Any type with a submit() that takes a callable and returns whether it was accepted
+ * qualifies, e.g. event_queue::Executor.
+ */
+template <typename Pool>
+concept NotifyPool = requires(Pool &pool, void (*task)()) {
+    { pool.submit(task) } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief How BasicSubject::notifyParallel() splits a notification.
+ */
+struct ParallelNotifyOptions {
+    std::size_t chunkSize = 256;            ///< Observers notified by one task (at least 1).
+    std::size_t sequentialThreshold = 1024; ///< Lists of this many observers or fewer are notified inline.
+};
+
+template <typename Event>
+class BasicTopicBroker;
+
+/**
+ * @brief Keeps an observer registered with a Subject; destroying it removes the observer.
+ *
+ * A Subscription is returned by Subject::addObserver(). Keeping it as a member of the observer
+ * ties the registration to the observer's lifetime, so a destroyed observer can never be
+ * notified. Removal takes O(1) time. A Subscription may outlive its Subject, in which case
+ * destroying it does nothing.
+ */
+class [[nodiscard]] Subscription {
+public:
+    /**
+     * @brief Creates an empty subscription.
+     */
+    Subscription() = default;
+
+    ~Subscription() { unsubscribe(); }
+
+    Subscription(const Subscription &) = delete;
+    Subscription &operator=(const Subscription &) = delete;
+
+    Subscription(Subscription &&other) noexcept
+        : registry_(std::move(other.registry_)), key_(std::exchange(other.key_, SlotKey{})) {}
+
+    Subscription &operator=(Subscription &&other) noexcept {
+        if (this != &other) {
+            unsubscribe();
+            registry_ = std::move(other.registry_);
+            key_ = std::exchange(other.key_, SlotKey{});
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Removes the observer from its subject now. Does nothing if it is already removed.
+     */
+    void unsubscribe() {
+        if (std::shared_ptr<detail::SubscriptionTarget> registry = registry_.lock()) {
+            registry->remove(key_);
+        }
+        detach();
+    }
+
+    /**
+     * @brief Lets go of the observer without removing it.
+     *
+     * The observer then stays registered until Subject::removeObserver() is called or the
+     * subject is destroyed.
+     */
+    void detach() {
+        registry_.reset();
+        key_ = SlotKey{};
+    }
+
+    /**
+     * @brief Returns true while the observer is registered through this subscription.
+     */
+    bool isActive() const {
+        std::shared_ptr<detail::SubscriptionTarget> registry = registry_.lock();
+        return registry && registry->contains(key_);
+    }
+
+private:
+    template <typename Event>
+    friend class BasicSubject;
+    template <typename Event>
+    friend class BasicTopicBroker;
+
+    Subscription(std::weak_ptr<detail::SubscriptionTarget> registry, SlotKey key)
+        : registry_(std::move(registry)), key_(key) {}
+
+    std::weak_ptr<detail::SubscriptionTarget> registry_; ///< Storage of the subject, if it still exists.
+    SlotKey key_;                                        ///< Key of the observer in the storage.
+};
+
 /**
- * @brief The Subject class manages a list of observers and notifies them of events.
+ * @brief The BasicSubject class manages a list of observers and notifies them of events.
+ *
+ * The BasicSubject class provides methods to add and remove observers, as well as to notify
+ * all registered observers by calling their onNotify() method. Observers may add or remove
+ * observers from inside onNotify(); observers added during a notification are first notified
+ * by the next one.
  *
- * The Subject class provides methods to add and remove observers, as well as to notify
- * all registered observers by calling their onNotify() method.
+ * A subject cannot be copied. A moved-from subject may only be assigned to or destroyed.
+ *
+ * @tparam Event The type of the events. notify() passes it to the observers by reference,
+ *               so an event is neither copied nor formatted on its way to them.
  */
-class Subject {
+template <typename Event>
+class BasicSubject {
 public:
+    using EventType = Event;                       ///< The type of the events.
+    using ObserverType = BasicObserver<Event>;     ///< The observers this subject notifies.
+
+    BasicSubject() : registry(std::make_shared<detail::ObserverRegistry<Event>>()) {}
+
+    BasicSubject(const BasicSubject &) = delete;
+    BasicSubject &operator=(const BasicSubject &) = delete;
+    BasicSubject(BasicSubject &&) noexcept = default;
+    BasicSubject &operator=(BasicSubject &&) noexcept = default;
+
     /**
      * @brief Adds an observer to the list of observers.
      *
-     * @param observer A pointer to an object implementing the IObserver interface.
+     * @param observer A pointer to an object implementing the BasicObserver interface.
+     * @return A handle that removes the observer when destroyed. Call Subscription::detach()
+     *         to keep the observer registered without holding the handle. Adding nullptr
+     *         returns an empty handle.
      */
-    void addObserver(IObserver* observer) {
-        observers.push_back(observer);
+    Subscription addObserver(ObserverType *observer) {
+        if (!observer) {
+            return Subscription{};
+        }
+        return Subscription(registry, registry->observers.insert(observer));
     }
 
     /**
-     * @brief Removes an observer from the list.
+     * @brief Removes every registration of an observer from the list.
+     *
+     * This searches the whole list; destroying or resetting the observer's Subscription
+     * removes it in O(1) instead.
      *
      * @param observer A pointer to the observer to remove.
      */
-    void removeObserver(IObserver* observer) {
-        observers.erase(
-            std::remove(observers.begin(), observers.end(), observer),
-            observers.end()
-        );
+    void removeObserver(ObserverType *observer) {
+        // Backwards, so that the value an erase moves into place has already been checked.
+        for (std::size_t i = registry->observers.size(); i > 0; --i) {
+            if (registry->observers[i - 1] == observer) {
+                registry->remove(registry->observers.keyAt(i - 1));
+            }
+        }
     }
 
     /**
      * @brief Notifies all registered observers of an event.
      *
      * This method calls the onNotify() function on each observer, passing the provided
-     * message.
+     * event.
+     *
+     * @param event The event, e.g. a string describing it.
+     */
+    void notify(const Event &event) {
+        detail::ObserverRegistry<Event> &observers = *registry;
+        NotifyScope scope(observers);
+        const std::size_t count = observers.observers.size();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (ObserverType *observer = observers.observers[i]) {
+                observer->onNotify(event);
+            }
+        }
+    }
+
+    /**
+     * @brief Notifies all registered observers of an event, in chunks run on a worker pool.
+     *
+     * The observer list is split into chunks of ParallelNotifyOptions::chunkSize observers.
+     * The calling thread notifies the first chunk itself and submits the others to @p pool;
+     * a chunk the pool refuses is run inline. Lists no larger than
+     * ParallelNotifyOptions::sequentialThreshold are notified inline, like notify().
      *
-     * @param message A string describing the event.
+     * The event is copied once, so it need not outlive the call. Observers run concurrently
+     * with each other and must not change this subject's subscriptions, and every observer
+     * must stay alive until the returned future is ready. Waiting for the future from a
+     * worker of @p pool may deadlock if the pool has no other worker free.
+     *
+     * @param event The event, e.g. a string describing it.
+     * @param pool The pool that runs the chunks, e.g. an event_queue::Executor.
+     * @param options Chunk size and sequential threshold.
+     * @return A future that becomes ready once every observer has been notified. If an
+     *         observer throws, the rest of its chunk is skipped, the other chunks still run,
+     *         and the future holds the first exception.
      */
-    void notify(const std::string &message) {
-        for (auto* observer : observers) {
+    template <typename Pool>
+        requires NotifyPool<Pool>
+    std::future<void> notifyParallel(const Event &event, Pool &pool, const ParallelNotifyOptions &options = {}) {
+        const std::size_t chunkSize = std::max<std::size_t>(options.chunkSize, 1);
+        const std::size_t count = observerCount();
+        if (count <= options.sequentialThreshold || count <= chunkSize) {
+            std::promise<void> done;
+            try {
+                notify(event);
+                done.set_value();
+            } catch (...) {
+                done.set_exception(std::current_exception());
+            }
+            return done.get_future();
+        }
+
+        std::vector<ObserverType *> observers;
+        observers.reserve(count);
+        for (ObserverType *observer : registry->observers) {
             if (observer) {
-                observer->onNotify(message);
+                observers.push_back(observer);
             }
         }
+        auto notification =
+            std::make_shared<detail::ParallelNotification<Event>>(event, std::move(observers), chunkSize);
+        std::future<void> result = notification->done.get_future();
+        const std::size_t chunks = notification->remaining.load(std::memory_order_relaxed);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+            if (!pool.submit([notification, chunk]() { notification->run(chunk); })) {
+                notification->run(chunk);
+            }
+        }
+        notification->run(0);
+        return result;
+    }
+
+    /**
+     * @brief Returns the number of registered observers.
+     */
+    std::size_t observerCount() const {
+        return registry->observers.size() - registry->deferred.size();
     }
 
 private:
-    std::vector<IObserver*> observers; ///< Container storing pointers to the registered observers.
+    /**
+     * @brief Marks a notification as running, and compacts the storage when the outermost one ends.
+     */
+    class NotifyScope {
+    public:
+        explicit NotifyScope(detail::ObserverRegistry<Event> &registry) : registry_(registry) { ++registry_.notifying; }
+        ~NotifyScope() {
+            if (--registry_.notifying == 0) {
+                registry_.compact();
+            }
+        }
+        NotifyScope(const NotifyScope &) = delete;
+        NotifyScope &operator=(const NotifyScope &) = delete;
+
+    private:
+        detail::ObserverRegistry<Event> &registry_;
+    };
+
+    std::shared_ptr<detail::ObserverRegistry<Event>> registry; ///< Storage of the registered observers.
 };
 
+/**
+ * @brief A subject whose events are string messages.
+ */
+using Subject = BasicSubject<std::string>;
+
 } // namespace observer
 
 #endif // SUBJECT_HPP
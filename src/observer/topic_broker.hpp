@@ -0,0 +1,476 @@
+/**
+ * @file topic_broker.hpp
+ * @brief Declaration of the BasicTopicBroker class, a publish/subscribe broker with wildcard topics.
+ *
+ * Topics are hierarchical names whose levels are separated by dots, such as "orders.eu.fr".
+ * A subscription pattern may use two wildcards, each as a whole level: "*" matches exactly one
+ * level, and "#" matches any number of levels, including none, and must be the last level.
+ * "orders.*.fr" thus matches "orders.eu.fr", and "orders.#" matches "orders" and
+ * "orders.eu.fr".
+ *
+ * Patterns are stored in a trie with one node per level. Publishing walks the trie level by
+ * level, following the literal child and the "*" child and collecting the "#" children, so its
+ * cost depends on the depth of the topic and on how many patterns overlap it, not on the number
+ * of topics or subscriptions. The subscriptions that match a topic are also kept in an LRU cache,
+ * so a hot topic costs one hash lookup. A subscribe or unsubscribe drops only the cached topics
+ * its pattern matches: one lookup for a pattern without wildcards, a scan of the (bounded) cache
+ * otherwise.
+ */
+
+#ifndef TOPIC_BROKER_HPP
+#define TOPIC_BROKER_HPP
+
+#include "observer.hpp"
+#include "slot_map.hpp"
+#include "subject.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace observer {
+
+namespace detail {
+
+/**
+ * @brief Hash that lets unordered containers keyed by std::string be searched with a string_view.
+ */
+struct TopicHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+};
+
+/**
+ * @brief Calls @p visit with each level of @p topic, in order.
+ */
+template <typename F>
+void forEachLevel(std::string_view topic, F &&visit) {
+    std::size_t start = 0;
+    while (true) {
+        const std::size_t dot = topic.find('.', start);
+        visit(topic.substr(start, dot == std::string_view::npos ? std::string_view::npos : dot - start),
+              dot == std::string_view::npos);
+        if (dot == std::string_view::npos) {
+            return;
+        }
+        start = dot + 1;
+    }
+}
+
+/**
+ * @brief The state of a BasicTopicBroker, shared with its Subscriptions.
+ */
+template <typename Event>
+class TopicRegistry final : public SubscriptionTarget {
+public:
+    using ObserverType = BasicObserver<Event>;
+    using Matches = std::vector<SlotKey>;
+
+    /**
+     * @brief One level of the subscription trie.
+     */
+    struct Node {
+        Node *parent = nullptr;   ///< Parent node; nullptr for the root.
+        std::string label;        ///< Level this node matches ("*" and "#" for the wildcards).
+        std::unordered_map<std::string, std::unique_ptr<Node>, TopicHash, std::equal_to<>> children; ///< Literal levels.
+        std::unique_ptr<Node> star; ///< Child for the "*" level.
+        std::unique_ptr<Node> hash; ///< Child for the "#" level.
+        SlotMap<SlotKey> subscribers; ///< Subscriptions whose pattern ends here.
+
+        bool isUnused() const { return subscribers.empty() && children.empty() && !star && !hash; }
+    };
+
+    /**
+     * @brief One subscription.
+     */
+    struct Entry {
+        ObserverType *observer; ///< The subscribed observer.
+        Node *node;             ///< Trie node of the pattern.
+        SlotKey nodeKey;        ///< Key of the subscription in the node.
+    };
+
+    /**
+     * @brief One level of the index of cached topics, used to find those a pattern matches.
+     */
+    struct IndexNode {
+        IndexNode *parent = nullptr; ///< Parent node; nullptr for the root.
+        std::string label;           ///< Topic level of this node.
+        std::unordered_map<std::string, std::unique_ptr<IndexNode>, TopicHash, std::equal_to<>> children;
+        const std::string *topic = nullptr; ///< Key of the cached topic ending here, if any.
+    };
+
+    /**
+     * @brief A cached match list.
+     */
+    struct CacheEntry {
+        std::shared_ptr<const Matches> matches;
+        std::list<const std::string *>::iterator recent; ///< Position in the recency list.
+        IndexNode *indexNode = nullptr;                  ///< The topic's node in the index.
+    };
+
+    using Cache = std::unordered_map<std::string, CacheEntry, TopicHash, std::equal_to<>>;
+
+    explicit TopicRegistry(std::size_t cacheCapacity) : cacheCapacity_(cacheCapacity) {}
+
+    /**
+     * @brief Adds a subscription of @p observer to @p pattern.
+     *
+     * @throws std::invalid_argument if a level mixes a wildcard with other characters, or if
+     *         "#" is not the last level.
+     */
+    SlotKey subscribe(std::string_view pattern, ObserverType *observer) {
+        validate(pattern); // Before any node is created, so a refused pattern leaves none behind.
+        Node *node = &root_;
+        forEachLevel(pattern, [&](std::string_view level, bool) {
+            if (level == "#") {
+                node = child(node->hash, node, level);
+            } else if (level == "*") {
+                node = child(node->star, node, level);
+            } else {
+                auto found = node->children.find(level);
+                if (found == node->children.end()) {
+                    auto created = std::make_unique<Node>();
+                    created->parent = node;
+                    created->label = std::string(level);
+                    found = node->children.emplace(created->label, std::move(created)).first;
+                }
+                node = found->second.get();
+            }
+        });
+        const SlotKey key = subscriptions_.insert(Entry{observer, node, SlotKey{}});
+        subscriptions_.find(key)->nodeKey = node->subscribers.insert(key);
+        invalidate(node);
+        return key;
+    }
+
+    bool contains(SlotKey key) const override { return subscriptions_.contains(key); }
+
+    void remove(SlotKey key) override {
+        const Entry *entry = subscriptions_.find(key);
+        if (!entry) {
+            return;
+        }
+        Node *node = entry->node;
+        invalidate(node);
+        node->subscribers.erase(entry->nodeKey);
+        subscriptions_.erase(key);
+        prune(node);
+    }
+
+    /**
+     * @brief Returns the subscriptions matching @p topic, from the cache if possible.
+     *
+     * @throws std::invalid_argument if @p topic contains a wildcard level.
+     */
+    std::shared_ptr<const Matches> match(std::string_view topic) {
+        if (cacheCapacity_ == 0) {
+            return std::make_shared<const Matches>(collect(topic));
+        }
+        auto found = cache_.find(topic);
+        if (found != cache_.end()) {
+            recent_.splice(recent_.begin(), recent_, found->second.recent);
+            return found->second.matches;
+        }
+        auto matches = std::make_shared<const Matches>(collect(topic));
+        if (cache_.size() >= cacheCapacity_) {
+            drop(cache_.find(*recent_.back()));
+        }
+        found = cache_.emplace(std::string(topic), CacheEntry{matches, {}, nullptr}).first;
+        recent_.push_front(&found->first);
+        found->second.recent = recent_.begin();
+        found->second.indexNode = index(found->first);
+        return matches;
+    }
+
+    /**
+     * @brief Returns the observer of subscription @p key, or nullptr if it has been removed.
+     */
+    ObserverType *observer(SlotKey key) const {
+        const Entry *entry = subscriptions_.find(key);
+        return entry ? entry->observer : nullptr;
+    }
+
+    std::size_t subscriptionCount() const { return subscriptions_.size(); }
+    std::size_t cachedTopics() const { return cache_.size(); }
+
+    /**
+     * @brief Returns the number of trie nodes, not counting the root.
+     */
+    std::size_t nodeCount() const { return countNodes(root_) - 1; }
+
+private:
+    /**
+     * @brief Throws std::invalid_argument if @p pattern misuses a wildcard.
+     */
+    static void validate(std::string_view pattern) {
+        forEachLevel(pattern, [](std::string_view level, bool last) {
+            if (level == "#" && !last) {
+                throw std::invalid_argument("'#' must be the last level of a topic pattern");
+            }
+            if (level != "#" && level != "*" && level.find_first_of("*#") != std::string_view::npos) {
+                throw std::invalid_argument("wildcards must fill a whole topic level");
+            }
+        });
+    }
+
+    static std::size_t countNodes(const Node &node) {
+        std::size_t count = 1;
+        for (const auto &child : node.children) {
+            count += countNodes(*child.second);
+        }
+        count += node.star ? countNodes(*node.star) : 0;
+        count += node.hash ? countNodes(*node.hash) : 0;
+        return count;
+    }
+
+    /**
+     * @brief Returns the wildcard child in @p slot, creating it if needed.
+     */
+    static Node *child(std::unique_ptr<Node> &slot, Node *parent, std::string_view label) {
+        if (!slot) {
+            slot = std::make_unique<Node>();
+            slot->parent = parent;
+            slot->label = std::string(label);
+        }
+        return slot.get();
+    }
+
+    /**
+     * @brief Drops the cached topics matched by the pattern that ends at @p node.
+     */
+    void invalidate(const Node *node) {
+        if (cache_.empty()) {
+            return;
+        }
+        std::vector<std::string_view> pattern;
+        for (; node != &root_; node = node->parent) {
+            pattern.push_back(node->label);
+        }
+        std::reverse(pattern.begin(), pattern.end());
+        std::vector<const std::string *> matched;
+        findCached(&index_, pattern, matched);
+        for (const std::string *topic : matched) {
+            drop(cache_.find(*topic));
+        }
+    }
+
+    /**
+     * @brief Appends to @p out the cached topics under @p node that match @p pattern.
+     */
+    static void findCached(const IndexNode *node, const std::vector<std::string_view> &pattern,
+                           std::vector<const std::string *> &out, std::size_t depth = 0) {
+        if (depth == pattern.size()) {
+            if (node->topic) {
+                out.push_back(node->topic);
+            }
+        } else if (pattern[depth] == "#") {
+            findCached(node, pattern, out, depth + 1); // No level at all.
+            for (const auto &child : node->children) {
+                findCached(child.second.get(), pattern, out, depth); // One level more.
+            }
+        } else if (pattern[depth] == "*") {
+            for (const auto &child : node->children) {
+                findCached(child.second.get(), pattern, out, depth + 1);
+            }
+        } else if (auto found = node->children.find(pattern[depth]); found != node->children.end()) {
+            findCached(found->second.get(), pattern, out, depth + 1);
+        }
+    }
+
+    /**
+     * @brief Adds the cached @p topic to the index.
+     */
+    IndexNode *index(const std::string &topic) {
+        IndexNode *node = &index_;
+        forEachLevel(topic, [&node](std::string_view level, bool) {
+            auto found = node->children.find(level);
+            if (found == node->children.end()) {
+                auto created = std::make_unique<IndexNode>();
+                created->parent = node;
+                created->label = std::string(level);
+                found = node->children.emplace(created->label, std::move(created)).first;
+            }
+            node = found->second.get();
+        });
+        node->topic = &topic;
+        return node;
+    }
+
+    /**
+     * @brief Removes a cache entry and its index node.
+     */
+    void drop(typename Cache::iterator entry) {
+        IndexNode *node = entry->second.indexNode;
+        node->topic = nullptr;
+        while (node != &index_ && !node->topic && node->children.empty()) {
+            IndexNode *parent = node->parent;
+            parent->children.erase(node->label);
+            node = parent;
+        }
+        recent_.erase(entry->second.recent);
+        cache_.erase(entry);
+    }
+
+    /**
+     * @brief Removes @p node and its ancestors while they hold nothing.
+     */
+    void prune(Node *node) {
+        while (node != &root_ && node->isUnused()) {
+            Node *parent = node->parent;
+            if (node == parent->star.get()) {
+                parent->star.reset();
+            } else if (node == parent->hash.get()) {
+                parent->hash.reset();
+            } else {
+                parent->children.erase(node->label);
+            }
+            node = parent;
+        }
+    }
+
+    /**
+     * @brief Walks the trie for @p topic and returns the matching subscriptions.
+     */
+    Matches collect(std::string_view topic) const {
+        Matches matches;
+        const auto take = [&matches](const Node *node) {
+            if (node) {
+                matches.insert(matches.end(), node->subscribers.begin(), node->subscribers.end());
+            }
+        };
+        // Reused between calls; collect() never calls out, so nested publishes cannot interfere.
+        std::vector<const Node *> &frontier = frontier_;
+        std::vector<const Node *> &next = next_;
+        frontier.assign(1, &root_);
+        forEachLevel(topic, [&](std::string_view level, bool) {
+            if (level == "*" || level == "#") {
+                throw std::invalid_argument("a published topic cannot contain wildcards");
+            }
+            next.clear();
+            for (const Node *node : frontier) {
+                take(node->hash.get()); // "#" matches this level and everything after it.
+                if (auto found = node->children.find(level); found != node->children.end()) {
+                    next.push_back(found->second.get());
+                }
+                if (node->star) {
+                    next.push_back(node->star.get());
+                }
+            }
+            frontier.swap(next);
+        });
+        for (const Node *node : frontier) {
+            take(node);
+            take(node->hash.get()); // "#" also matches no level at all.
+        }
+        return matches;
+    }
+
+    Node root_;                                   ///< Root of the trie (the empty prefix).
+    SlotMap<Entry> subscriptions_;                ///< Every subscription.
+    std::size_t cacheCapacity_;                   ///< Maximum number of cached topics.
+    Cache cache_;                                 ///< Match lists by topic.
+    IndexNode index_;                             ///< The cached topics, as a trie.
+    std::list<const std::string *> recent_;       ///< Cached topics, most recently published first.
+    mutable std::vector<const Node *> frontier_;  ///< Scratch: trie nodes matching the levels so far.
+    mutable std::vector<const Node *> next_;      ///< Scratch: trie nodes matching one more level.
+};
+
+} // namespace detail
+
+/**
+ * @brief A publish/subscribe broker that routes events to observers by topic.
+ *
+ * Observers subscribe to topic patterns and receive every event published on a matching topic.
+ * A subscription lasts as long as the returned Subscription. Observers may publish, subscribe
+ * and unsubscribe from inside onNotify(); an observer unsubscribed during a publish is not
+ * notified by the rest of it, and an observer subscribed during a publish is first notified by
+ * the next one. The broker is not thread-safe.
+ *
+ * @tparam Event The type of the events, passed to the observers by reference.
+ */
+template <typename Event>
+class BasicTopicBroker {
+public:
+    using EventType = Event;                   ///< The type of the events.
+    using ObserverType = BasicObserver<Event>; ///< The observers this broker notifies.
+
+    /**
+     * @brief Broker configuration.
+     */
+    struct Options {
+        std::size_t cacheCapacity = 4096; ///< Number of topics whose matches are cached; 0 disables the cache.
+    };
+
+    BasicTopicBroker() : BasicTopicBroker(Options{}) {}
+
+    explicit BasicTopicBroker(const Options &options)
+        : registry_(std::make_shared<detail::TopicRegistry<Event>>(options.cacheCapacity)) {}
+
+    BasicTopicBroker(const BasicTopicBroker &) = delete;
+    BasicTopicBroker &operator=(const BasicTopicBroker &) = delete;
+
+    /**
+     * @brief Subscribes @p observer to the topics matching @p pattern.
+     *
+     * @return A handle that ends the subscription when destroyed. Subscribing nullptr returns
+     *         an empty handle.
+     * @throws std::invalid_argument if the pattern misuses a wildcard.
+     */
+    Subscription subscribe(std::string_view pattern, ObserverType *observer) {
+        if (!observer) {
+            return Subscription{};
+        }
+        return Subscription(registry_, registry_->subscribe(pattern, observer));
+    }
+
+    /**
+     * @brief Notifies the observers of every pattern matching @p topic.
+     *
+     * An observer subscribed through several matching patterns is notified once per pattern.
+     *
+     * @return The number of notifications delivered.
+     * @throws std::invalid_argument if @p topic contains a wildcard level.
+     */
+    std::size_t publish(std::string_view topic, const Event &event) {
+        // Hold the list: a nested publish may replace or evict the cache entry.
+        const std::shared_ptr<const std::vector<SlotKey>> matches = registry_->match(topic);
+        std::size_t delivered = 0;
+        for (SlotKey key : *matches) {
+            if (ObserverType *observer = registry_->observer(key)) {
+                observer->onNotify(event);
+                ++delivered;
+            }
+        }
+        return delivered;
+    }
+
+    /**
+     * @brief Returns the number of active subscriptions.
+     */
+    std::size_t subscriptionCount() const { return registry_->subscriptionCount(); }
+
+    /**
+     * @brief Returns the number of topics whose matches are cached.
+     */
+    std::size_t cachedTopics() const { return registry_->cachedTopics(); }
+
+private:
+    std::shared_ptr<detail::TopicRegistry<Event>> registry_; ///< Trie, subscriptions and match cache.
+};
+
+/**
+ * @brief A topic broker whose events are string messages.
+ */
+using TopicBroker = BasicTopicBroker<std::string>;
+
+} // namespace observer
+
+#endif // TOPIC_BROKER_HPP
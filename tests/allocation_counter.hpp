@@ -0,0 +1,149 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+/**
+ * @file allocation_counter.hpp
+ * @brief Replaces the global allocation functions with versions that count allocations.
+ *
+ * Tests and benchmarks that check a code path does not allocate include this header and compare
+ * allocationCount before and after the path runs. Every replaceable form of operator new and
+ * operator delete is replaced: plain, array, nothrow, sized and aligned. All of them allocate
+ * with malloc() or aligned_alloc() and release with free(), so memory from any form can be
+ * released by the matching delete.
+ *
+ * The definitions are not inline (replacement allocation functions may not be), so the header
+ * must be included by exactly one translation unit of a program. The functions are also kept
+ * out of line: inlined into a caller, GCC would see free() applied to memory from operator new
+ * and report -Wmismatched-new-delete.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__)
+#define ALLOCATION_COUNTER_NOINLINE __attribute__((noinline))
+#else
+#define ALLOCATION_COUNTER_NOINLINE
+#endif
+
+/**
+ * @brief Number of calls to the global operator new (any form), used to detect allocations.
+ */
+static std::atomic<std::size_t> allocationCount{0};
+
+namespace allocation_counter {
+
+/**
+ * @brief Counts and performs one allocation; returns nullptr on failure.
+ */
+inline void *allocate(std::size_t size, std::size_t alignment = 0) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    // aligned_alloc() requires the size to be a multiple of the alignment.
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+/**
+ * @brief Performs one allocation, throwing std::bad_alloc on failure.
+ */
+inline void *allocateOrThrow(std::size_t size, std::size_t alignment = 0) {
+    if (void *p = allocate(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace allocation_counter
+
+ALLOCATION_COUNTER_NOINLINE void *operator new(std::size_t size) {
+    return allocation_counter::allocateOrThrow(size);
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new[](std::size_t size) {
+    return allocation_counter::allocateOrThrow(size);
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return allocation_counter::allocate(size);
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return allocation_counter::allocate(size);
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new(std::size_t size, std::align_val_t alignment) {
+    return allocation_counter::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocation_counter::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new(std::size_t size, std::align_val_t alignment,
+                                               const std::nothrow_t &) noexcept {
+    return allocation_counter::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+ALLOCATION_COUNTER_NOINLINE void *operator new[](std::size_t size, std::align_val_t alignment,
+                                                 const std::nothrow_t &) noexcept {
+    return allocation_counter::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete(void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete[](void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+ALLOCATION_COUNTER_NOINLINE void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+#undef ALLOCATION_COUNTER_NOINLINE
+
+#endif // ALLOCATION_COUNTER_HPP
@@ -0,0 +1,297 @@
+/**
+ * @file concurrent_subject_test.cpp
+ * @brief Unit tests for the ConcurrentSubject class.
+ *
+ * This file contains unit tests for the lock-free-notify subject to verify that:
+ * - Observers are notified in registration order, and removed observers are not notified.
+ * - Several threads can notify while another thread keeps adding, removing and destroying
+ *   observers, without a removed observer ever being reached after removeObserver() returns.
+ * - An observer can remove itself, or add another observer, from inside onNotify().
+ * - Retired snapshots are reclaimed once no notification can still see them.
+ * - Observers removing themselves on two threads at once, from one subject or from two, do not
+ *   deadlock, and a slow reader of one subject does not hold up removals from another.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the ConcurrentSubject implementation.
+ */
+
+#include "observer/concurrent_subject.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace observer;
+
+namespace {
+
+/**
+ * @brief Records the messages it receives.
+ */
+class RecordingObserver : public IObserver {
+public:
+    void onNotify(const std::string &message) override { messages.push_back(message); }
+
+    std::vector<std::string> messages; ///< Received messages, in order.
+};
+
+/**
+ * @brief Counts notifications and checks that it is still alive when notified.
+ */
+class GuardedObserver : public IObserver {
+public:
+    ~GuardedObserver() override { magic_ = 0; }
+
+    void onNotify(const std::string &) override {
+        assert(magic_ == kAlive && "A destroyed observer must never be notified.");
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::uint64_t kAlive = 0x0b5e12fe12a11feull;
+    volatile std::uint64_t magic_ = kAlive;
+    std::atomic<std::uint64_t> count_{0};
+};
+
+/**
+ * @brief Removes itself from its subject, and adds a partner, on its first notification.
+ */
+class SelfRemovingObserver : public IObserver {
+public:
+    SelfRemovingObserver(ConcurrentSubject &subject, IObserver &partner) : subject_(subject), partner_(partner) {}
+
+    void onNotify(const std::string &) override {
+        ++calls;
+        subject_.removeObserver(this);
+        subject_.addObserver(&partner_);
+    }
+
+    int calls = 0; ///< Number of notifications received.
+
+private:
+    ConcurrentSubject &subject_;
+    IObserver &partner_;
+};
+
+/**
+ * @brief Removes itself from its subject; the first notification first waits on a latch, so that
+ * every thread taking part is inside a notification when the removals start.
+ */
+class RendezvousRemover : public IObserver {
+public:
+    RendezvousRemover(ConcurrentSubject &subject, std::latch &inside) : subject_(subject), inside_(inside) {}
+
+    void onNotify(const std::string &) override {
+        if (calls.fetch_add(1) == 0) {
+            inside_.arrive_and_wait();
+        }
+        subject_.removeObserver(this);
+    }
+
+    std::atomic<int> calls{0}; ///< Number of notifications received.
+
+private:
+    ConcurrentSubject &subject_;
+    std::latch &inside_;
+};
+
+/**
+ * @brief Waits up to ten seconds for @p finished to reach @p expected.
+ */
+bool finishesInTime(const std::atomic<int> &finished, int expected) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (finished.load() != expected) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Single-threaded behavior matches Subject.
+    {
+        ConcurrentSubject subject;
+        RecordingObserver first;
+        RecordingObserver second;
+        subject.addObserver(&first);
+        subject.addObserver(&second);
+        assert(subject.observerCount() == 2);
+        subject.notify("one");
+        subject.removeObserver(&first);
+        subject.removeObserver(&first); // Removing an unknown observer is a no-op.
+        subject.notify("two");
+        assert(first.messages == std::vector<std::string>{"one"} && "A removed observer should not be notified.");
+        assert((second.messages == std::vector<std::string>{"one", "two"}));
+        assert(subject.observerCount() == 1);
+    }
+
+    // Test 2: Concurrent notifiers with concurrent subscription churn.
+    {
+        ConcurrentSubject subject;
+        GuardedObserver stable;
+        subject.addObserver(&stable);
+
+        constexpr int kNotifiers = 3;
+        constexpr int kChurn = 1000;
+        std::atomic<bool> done{false};
+        std::vector<std::thread> notifiers;
+        std::atomic<std::uint64_t> notifications{0};
+        for (int t = 0; t < kNotifiers; ++t) {
+            notifiers.emplace_back([&]() {
+                const std::string message = "tick";
+                while (!done.load(std::memory_order_acquire)) {
+                    subject.notify(message);
+                    notifications.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (int i = 0; i < kChurn; ++i) {
+            auto transient = std::make_unique<GuardedObserver>();
+            subject.addObserver(transient.get());
+            if (i % 7 == 0) {
+                std::this_thread::yield(); // Give notifiers a chance to reach it.
+            }
+            subject.removeObserver(transient.get());
+            transient.reset(); // Safe: no notification can still reach it.
+        }
+        done.store(true, std::memory_order_release);
+        for (std::thread &thread : notifiers) {
+            thread.join();
+        }
+        assert(stable.count() == notifications.load() && "Every notification should reach the stable observer.");
+        assert(subject.observerCount() == 1);
+    }
+
+    // Test 3: Changing the subscriptions from inside onNotify().
+    {
+        ConcurrentSubject subject;
+        RecordingObserver partner;
+        SelfRemovingObserver remover(subject, partner);
+        subject.addObserver(&remover);
+        subject.notify("first");
+        assert(remover.calls == 1);
+        assert(partner.messages.empty() && "An observer added during notify() is not reached by that notify().");
+        subject.notify("second");
+        assert(remover.calls == 1 && "An observer that removed itself should not be notified again.");
+        assert(partner.messages == std::vector<std::string>{"second"});
+    }
+
+    // Test 4: Retired snapshots are reclaimed.
+    {
+        ConcurrentSubject subject;
+        RecordingObserver observer;
+        for (int i = 0; i < 100; ++i) {
+            subject.addObserver(&observer);
+            subject.removeObserver(&observer);
+        }
+        assert(subject.retiredSnapshots() == 0 && "With no reader running, every snapshot should be freed.");
+
+        // A reader running on another thread holds back reclamation until it returns.
+        std::atomic<bool> inside{false};
+        std::atomic<bool> release{false};
+        struct BlockingObserver : IObserver {
+            std::atomic<bool> &inside;
+            std::atomic<bool> &release;
+            BlockingObserver(std::atomic<bool> &in, std::atomic<bool> &out) : inside(in), release(out) {}
+            void onNotify(const std::string &) override {
+                inside.store(true);
+                while (!release.load()) {
+                    std::this_thread::yield();
+                }
+            }
+        } blocker(inside, release);
+        subject.addObserver(&blocker);
+        std::thread reader([&subject]() { subject.notify("slow"); });
+        while (!inside.load()) {
+            std::this_thread::yield();
+        }
+        subject.addObserver(&observer);
+        assert(subject.retiredSnapshots() == 1 && "The snapshot the reader uses should not be freed.");
+        release.store(true);
+        reader.join();
+        subject.addObserver(&observer);
+        assert(subject.retiredSnapshots() == 0 && "It should be freed once the reader has returned.");
+    }
+
+    // Test 5: Self-removal on two threads at once, from two subjects and from one.
+    for (bool shared : {false, true}) {
+        ConcurrentSubject first;
+        ConcurrentSubject second;
+        ConcurrentSubject &other = shared ? first : second;
+        std::latch inside(2);
+        RendezvousRemover a(first, inside);
+        RendezvousRemover b(other, inside);
+        first.addObserver(&a);
+        other.addObserver(&b);
+        std::atomic<int> finished{0};
+        // With one subject, the second thread reaches the latch through b after removing a.
+        std::thread t1([&]() {
+            first.notify("x");
+            finished.fetch_add(1);
+        });
+        std::thread t2([&]() {
+            other.notify("y");
+            finished.fetch_add(1);
+        });
+        if (!finishesInTime(finished, 2)) {
+            std::cerr << "Concurrent self-removal deadlocked." << std::endl;
+            std::abort();
+        }
+        t1.join();
+        t2.join();
+        assert(first.observerCount() == 0 && other.observerCount() == 0);
+        first.notify("after");
+        other.notify("after");
+    }
+
+    // Test 6: A slow reader of one subject does not hold up removals from another.
+    {
+        ConcurrentSubject slow;
+        ConcurrentSubject fast;
+        std::atomic<bool> inside{false};
+        std::atomic<bool> release{false};
+        struct BlockingObserver : IObserver {
+            std::atomic<bool> &inside;
+            std::atomic<bool> &release;
+            BlockingObserver(std::atomic<bool> &in, std::atomic<bool> &out) : inside(in), release(out) {}
+            void onNotify(const std::string &) override {
+                inside.store(true);
+                while (!release.load()) {
+                    std::this_thread::yield();
+                }
+            }
+        } blocker(inside, release);
+        slow.addObserver(&blocker);
+        std::thread reader([&slow]() { slow.notify("slow"); });
+        while (!inside.load()) {
+            std::this_thread::yield();
+        }
+        RecordingObserver observer;
+        std::atomic<int> finished{0};
+        std::thread remover([&]() {
+            fast.addObserver(&observer);
+            fast.removeObserver(&observer);
+            finished.fetch_add(1);
+        });
+        const bool removed = finishesInTime(finished, 1);
+        release.store(true);
+        reader.join();
+        remover.join();
+        assert(removed && "removeObserver() should only wait for readers of its own subject.");
+    }
+
+    std::cout << "All concurrent subject tests passed." << std::endl;
+    return 0;
+}
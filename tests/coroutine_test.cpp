@@ -0,0 +1,116 @@
+/**
+ * @file coroutine_test.cpp
+ * @brief Unit tests for Task and EventQueue::schedule().
+ *
+ * This file contains unit tests for the coroutine support of the event queue to verify that:
+ * - A Task is lazy, and co_await queue.schedule() resumes it from processEvents().
+ * - Awaiting nested tasks yields their values, and exceptions propagate to the awaiter.
+ * - A coroutine scheduled from a producer thread resumes on the consumer thread.
+ * - Each co_await queue.schedule() step runs without any heap allocation.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the coroutine support.
+ */
+
+#include "event_queue/coroutine.hpp"
+#include "event_queue/event_queue.hpp"
+#include "allocation_counter.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace event_queue;
+
+namespace {
+
+Task<int> length(EventQueue &queue, std::string text) {
+    co_await queue.schedule();
+    co_return static_cast<int>(text.size());
+}
+
+Task<int> fail(EventQueue &queue) {
+    co_await queue.schedule();
+    throw std::runtime_error("stage failed");
+}
+
+Task<> pipeline(EventQueue &queue, std::vector<std::string> &log) {
+    log.push_back("start");
+    const int a = co_await length(queue, "hello");
+    const int b = co_await length(queue, "world!");
+    log.push_back("sum " + std::to_string(a + b));
+    try {
+        co_await fail(queue);
+    } catch (const std::runtime_error &error) {
+        log.push_back(error.what());
+    }
+}
+
+Task<> countSteps(EventQueue &queue, int steps, int &counter) {
+    for (int i = 0; i < steps; ++i) {
+        co_await queue.schedule();
+        ++counter;
+    }
+}
+
+Task<> hopToConsumer(EventQueue &queue, std::thread::id &resumedOn) {
+    co_await queue.schedule(EventQueue::Priority::High);
+    resumedOn = std::this_thread::get_id();
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Tasks are lazy; schedule() resumes them from processEvents(); values and
+    // exceptions flow through co_await.
+    {
+        EventQueue eq;
+        std::vector<std::string> log;
+        Task<> task = pipeline(eq, log);
+        assert(log.empty() && "A task should not run before it is started.");
+        task.start();
+        assert(log.size() == 1 && !task.done() && "The task should suspend at its first schedule().");
+        while (!task.done()) {
+            eq.processEvents();
+        }
+        task.result();
+        const std::vector<std::string> expected{"start", "sum 11", "stage failed"};
+        assert(log == expected && "The pipeline should see every value and the exception.");
+        assert(eq.isEmpty() && "No event should be left once the task is done.");
+    }
+
+    // Test 2: A coroutine started on a producer thread continues on the consumer thread.
+    {
+        EventQueue eq;
+        std::thread::id resumedOn;
+        Task<> task = hopToConsumer(eq, resumedOn);
+        std::thread producer([&task]() { task.start(); });
+        producer.join();
+        assert(!task.done() && "The task should wait for the consumer.");
+        eq.waitAndProcess();
+        assert(task.done() && resumedOn == std::this_thread::get_id() &&
+               "The task should resume on the thread running processEvents().");
+    }
+
+    // Test 3: Steps reuse the coroutine frame; scheduling and resuming never allocate.
+    {
+        EventQueue eq;
+        int counter = 0;
+        Task<> task = countSteps(eq, 1000, counter);
+        task.start();
+        eq.processEvents(); // Let the queue's storage reach its steady-state capacity.
+        const std::size_t before = allocationCount.load();
+        while (!task.done()) {
+            eq.processEvents(EventQueue::DrainMode::Batch);
+        }
+        assert(counter == 1000 && "Every step should run.");
+        assert(allocationCount.load() == before && "Awaiting schedule() should not allocate.");
+    }
+
+    std::cout << "All coroutine tests passed." << std::endl;
+    return 0;
+}
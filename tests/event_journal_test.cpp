@@ -0,0 +1,230 @@
+/**
+ * @file event_journal_test.cpp
+ * @brief Unit tests for EventJournal, JournalReader and TypedEventJournal.
+ *
+ * This file contains unit tests for the event journal to verify that:
+ * - Journaled typed events are replayed into a TypedEventQueue in append order.
+ * - Records roll over into new segments and a reopened journal continues after its last record.
+ * - A damaged (torn) record ends its segment on replay, and the journal reopened after it
+ *   appends to a fresh segment that replays normally.
+ * - Oversized records are refused, records of unknown type fail the replay, and clear()
+ *   empties the journal.
+ * - Threads appending while others commit and segments roll over lose no records.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the journal.
+ */
+
+#include "event_queue/event_journal.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace event_queue;
+
+namespace {
+
+struct Deposit {
+    std::uint64_t account;
+    std::int64_t amount;
+};
+
+struct Withdrawal {
+    std::uint64_t account;
+    std::int64_t amount;
+    std::uint32_t reason;
+};
+
+using Journal = TypedEventJournal<Deposit, Withdrawal>;
+
+/**
+ * @brief Replays @p directory and returns the signed amounts in order.
+ */
+std::vector<std::int64_t> replayAmounts(const std::filesystem::path &directory) {
+    Journal::Queue queue;
+    Journal::replay(directory, queue);
+    std::vector<std::int64_t> amounts;
+    queue.processEvents(Overloaded{
+        [&](const Deposit &event) { amounts.push_back(event.amount); },
+        [&](const Withdrawal &event) { amounts.push_back(-event.amount); },
+    });
+    return amounts;
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path root =
+        std::filesystem::temp_directory_path() / ("event_journal_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(root);
+
+    // Test 1: Typed events are replayed in append order.
+    {
+        const auto directory = root / "typed";
+        {
+            Journal journal(directory);
+            Journal::Queue live;
+            for (int i = 1; i <= 100; ++i) {
+                if (i % 3 == 0) {
+                    journal.push(live, Withdrawal{7, i, 1});
+                } else {
+                    journal.push(live, Deposit{7, i});
+                }
+            }
+            assert(live.size() == 100 && "push() should also enqueue the events.");
+            assert(journal.journal().appendedRecords() == 100);
+        } // Committed and closed here.
+        const std::vector<std::int64_t> amounts = replayAmounts(directory);
+        assert(amounts.size() == 100 && "Every journaled event should be replayed.");
+        for (int i = 1; i <= 100; ++i) {
+            assert(amounts[i - 1] == (i % 3 == 0 ? -i : i) && "Events should be replayed in order.");
+        }
+    }
+
+    // Test 2: Segment rollover and reopening.
+    {
+        const auto directory = root / "segments";
+        EventJournal::Options options;
+        options.segmentSize = 4096;
+        options.commitEveryRecords = 64;
+        options.syncMode = EventJournal::SyncMode::Async;
+        {
+            Journal journal(directory, options);
+            for (int i = 0; i < 1000; ++i) {
+                journal.append(Deposit{1, i});
+            }
+        }
+        std::size_t segments = 0;
+        for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+            segments += entry.path().extension() == ".journal" ? 1 : 0;
+        }
+        assert(segments > 1 && "A small segment size should spread records over several files.");
+        {
+            Journal journal(directory, options);
+            for (int i = 1000; i < 1500; ++i) {
+                journal.append(Deposit{1, i});
+            }
+        }
+        const std::vector<std::int64_t> amounts = replayAmounts(directory);
+        assert(amounts.size() == 1500 && "Reopening should continue after the last record.");
+        for (int i = 0; i < 1500; ++i) {
+            assert(amounts[i] == i);
+        }
+    }
+
+    // Test 3: A torn record ends its segment.
+    {
+        const auto directory = root / "torn";
+        {
+            EventJournal journal(directory);
+            for (int i = 0; i < 10; ++i) {
+                journal.append(0, Deposit{2, i});
+            }
+        }
+        // Corrupt the payload of the last record (the segment header is 16 bytes and every
+        // Deposit record takes 32).
+        const auto segment = directory / "00000001.journal";
+        {
+            std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(16 + 9 * 32 + 16 + 8);
+            file.put('\x7f');
+        }
+        assert(replayAmounts(directory).size() == 9 && "Replay should stop at the damaged record.");
+        {
+            EventJournal journal(directory);
+            journal.append(0, Deposit{2, 100});
+        }
+        const std::vector<std::int64_t> amounts = replayAmounts(directory);
+        assert(amounts.size() == 10 && amounts.back() == 100 && "Appends after a torn record should replay.");
+        assert(std::filesystem::exists(directory / "00000002.journal") && "A fresh segment should be used.");
+    }
+
+    // Test 4: Errors and clear().
+    {
+        const auto directory = root / "errors";
+        EventJournal::Options options;
+        options.segmentSize = 256;
+        EventJournal journal(directory, options);
+        std::vector<std::byte> large(512);
+        bool threw = false;
+        try {
+            journal.append(0, large);
+        } catch (const std::length_error &) {
+            threw = true;
+        }
+        assert(threw && "A record larger than a segment should be refused.");
+
+        journal.append(9, Deposit{3, 1});
+        journal.commit();
+        threw = false;
+        try {
+            replayAmounts(directory);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && "An unknown record type should fail the replay.");
+
+        journal.clear();
+        journal.append(0, Deposit{3, 5});
+        journal.commit();
+        const std::vector<std::int64_t> amounts = replayAmounts(directory);
+        assert(amounts.size() == 1 && amounts[0] == 5 && "clear() should drop the earlier records.");
+
+        std::size_t records = 0;
+        JournalReader reader(directory);
+        reader.forEach([&records](const JournalReader::Record &record) {
+            records += record.payload.size() == sizeof(Deposit) ? 1 : 0;
+        });
+        assert(records == 1);
+    }
+
+    // Test 5: Concurrent appends and commits.
+    {
+        const auto directory = root / "concurrent";
+        EventJournal::Options options;
+        options.segmentSize = 8192;
+        options.commitEveryRecords = 16;
+        options.syncMode = EventJournal::SyncMode::Sync;
+        constexpr int kThreads = 4;
+        constexpr int kPerThread = 500;
+        {
+            Journal journal(directory, options);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < kThreads; ++t) {
+                threads.emplace_back([&journal, t]() {
+                    for (int i = 0; i < kPerThread; ++i) {
+                        journal.append(Deposit{static_cast<std::uint64_t>(t), i});
+                        if (i % 100 == 0) {
+                            journal.journal().commit();
+                        }
+                    }
+                });
+            }
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+            assert(journal.journal().appendedRecords() == kThreads * kPerThread);
+        }
+        std::vector<int> next(kThreads, 0);
+        JournalReader reader(directory);
+        const std::size_t records = reader.forEach([&next](const JournalReader::Record &record) {
+            Deposit deposit;
+            std::memcpy(&deposit, record.payload.data(), sizeof(deposit));
+            assert(deposit.amount == next[deposit.account] && "Each thread's records should keep their order.");
+            ++next[deposit.account];
+        });
+        assert(records == kThreads * kPerThread && "No record should be lost to a concurrent commit.");
+    }
+
+    std::filesystem::remove_all(root);
+    std::cout << "All event journal tests passed." << std::endl;
+    return 0;
+}
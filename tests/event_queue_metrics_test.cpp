@@ -0,0 +1,123 @@
+/**
+ * @file event_queue_metrics_test.cpp
+ * @brief Unit tests for the EventQueue instrumentation (EVENT_QUEUE_ENABLE_METRICS).
+ *
+ * This file contains unit tests for the queue metrics to verify that:
+ * - The log-linear histogram maps every value into a bucket whose bounds contain it, with
+ *   buckets no wider than 1/8 of their lower bound.
+ * - Pushed, dispatched and dropped events are counted, and the depth and high-water mark
+ *   follow the queue across every backend.
+ * - The queue-wait histogram reflects how long events sat in the queue, and the handler-time
+ *   histogram reflects how long handlers ran (including timers).
+ * - Counters recorded concurrently by several producer threads are merged without loss.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the queue metrics.
+ */
+
+#include "event_queue/event_queue.hpp"
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace event_queue;
+
+int main() {
+    static_assert(EventQueue::kMetricsEnabled, "This test must be built with EVENT_QUEUE_ENABLE_METRICS=1.");
+
+    // Test 1: Histogram bucket bounds.
+    {
+        for (std::uint64_t value : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 1000ull, 123456789ull, 1ull << 39}) {
+            const std::size_t bucket = LatencyHistogram::bucketFor(value);
+            assert(bucket < LatencyHistogram::kBucketCount);
+            assert(LatencyHistogram::lowerBound(bucket) <= value && value <= LatencyHistogram::upperBound(bucket));
+        }
+        for (std::size_t bucket = LatencyHistogram::kSubBuckets; bucket + 1 < LatencyHistogram::kBucketCount; ++bucket) {
+            const std::uint64_t low = LatencyHistogram::lowerBound(bucket);
+            assert(LatencyHistogram::bucketFor(low) == bucket && "Buckets should be contiguous.");
+            assert((LatencyHistogram::upperBound(bucket) - low + 1) * 8 <= low && "Buckets should be within 12.5%.");
+        }
+        assert(LatencyHistogram::bucketFor(UINT64_MAX) == LatencyHistogram::kBucketCount - 1);
+    }
+
+    // Test 2: Counters, depth and high-water mark.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing,
+                             EventQueue::Backend::ShardedSpsc}) {
+            EventQueue eq(backend, 64);
+            for (int i = 0; i < 10; ++i) {
+                eq.pushEvent([]() {});
+            }
+            QueueMetricsSnapshot snapshot = eq.metrics();
+            assert(snapshot.enqueued == 10 && snapshot.depth == 10 && snapshot.highWaterMark == 10);
+            eq.processUpTo(4);
+            snapshot = eq.metrics();
+            assert(snapshot.dispatched == 4 && snapshot.depth == 6 && snapshot.highWaterMark == 10);
+            eq.processEvents();
+            snapshot = eq.metrics();
+            assert(snapshot.dispatched == 10 && snapshot.depth == 0 && snapshot.highWaterMark == 10);
+            assert(snapshot.queueWait.count() == 10 && snapshot.handlerTime.count() == 10);
+        }
+
+        // Evicted events are counted as dropped, not dispatched.
+        EventQueue::Options options;
+        options.capacity = 2;
+        options.overflowPolicy = EventQueue::OverflowPolicy::DropOldest;
+        EventQueue eq(options);
+        for (int i = 0; i < 5; ++i) {
+            eq.pushEvent([]() {});
+        }
+        eq.processEvents(EventQueue::DrainMode::Batch);
+        const QueueMetricsSnapshot snapshot = eq.metrics();
+        assert(snapshot.enqueued == 5 && snapshot.dropped == 3 && snapshot.dispatched == 2 && snapshot.depth == 0);
+        assert(snapshot.highWaterMark == 2);
+    }
+
+    // Test 3: Queue-wait and handler-time histograms.
+    {
+        using namespace std::chrono_literals;
+        EventQueue eq;
+        eq.pushEvent([]() {});
+        std::this_thread::sleep_for(5ms);
+        eq.pushEvent([]() { std::this_thread::sleep_for(5ms); });
+        eq.processEvents();
+        const QueueMetricsSnapshot snapshot = eq.metrics();
+        assert(snapshot.queueWait.percentile(1.0) >= 5ms && "The first event waited at least 5ms.");
+        assert(snapshot.queueWait.percentile(0.0) < 5ms && "The second event was dispatched right away.");
+        assert(snapshot.handlerTime.percentile(1.0) >= 5ms && snapshot.handlerTime.mean() >= 2ms);
+
+        eq.scheduleAfter(0ms, []() { std::this_thread::sleep_for(1ms); });
+        std::this_thread::sleep_for(2ms);
+        eq.processEvents();
+        assert(eq.metrics().handlerTime.count() == 3 && "Timers should be timed as well.");
+    }
+
+    // Test 4: Concurrent producers.
+    {
+        constexpr int kThreads = 4;
+        constexpr int kEventsPerThread = 5000;
+        EventQueue eq(EventQueue::Backend::LockFreeRing, 1u << 15);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&eq]() {
+                for (int i = 0; i < kEventsPerThread; ++i) {
+                    eq.pushEvent([]() {});
+                }
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        QueueMetricsSnapshot snapshot = eq.metrics();
+        assert(snapshot.enqueued == kThreads * kEventsPerThread && snapshot.depth == kThreads * kEventsPerThread);
+        eq.processEvents();
+        snapshot = eq.metrics();
+        assert(snapshot.dispatched == kThreads * kEventsPerThread && snapshot.depth == 0);
+        assert(snapshot.queueWait.count() == kThreads * kEventsPerThread);
+    }
+
+    std::cout << "All event queue metrics tests passed." << std::endl;
+    return 0;
+}
@@ -7,15 +7,54 @@
  * - Events are processed in FIFO order.
  * - Side effects from events occur as expected.
  * - The EventQueue is thread-safe by simulating concurrent event enqueuing.
+ * - The lock-free ring backend preserves per-producer FIFO order while a consumer
+ *   drains it concurrently, including when the ring is full.
+ * - Events whose callable fits the inline buffer are pushed and dispatched without any heap
+ *   allocation, and move-only or oversized callables are still supported. An empty
+ *   std::function or a null function pointer makes an empty event, which is skipped.
+ * - Batch draining runs only the events pending when the drain started; events pushed during
+ *   the drain are deferred to the next batch, and the batch buffer is reused without allocating.
+ * - A consumer blocked in waitAndProcess() is woken by a push from another thread, and
+ *   waitFor() reports a timeout on an empty queue.
+ * - Priority lanes are served in strict priority or weighted round-robin order, with FIFO
+ *   order preserved inside each lane.
+ * - Delayed and periodic events run once due (never early), can be cancelled, and wake a
+ *   blocked consumer; the timing wheel fires timers across all of its levels exactly once.
+ * - A bounded queue applies its overflow policy (block, fail fast, drop oldest, drop newest),
+ *   counts what it drops, and never allocates once constructed.
+ * - The sharded backend keeps every registered producer's events in FIFO order, and with a
+ *   global sequence runs events from different producers in push order.
+ * - Coalesced events replace a pending event with the same key at its original position, and
+ *   a key becomes free again once its event has run or been dropped.
+ * - processUpTo() and processFor() stop at their count or time budget even when handlers keep
+ *   the queue non-empty, and report how many events ran and remain.
+ * - Payload events receive a copy of their bytes from the queue's arena, the arena reclaims its
+ *   chunks once a drained batch has run, and steady-state payload traffic does not allocate.
+ * - TypedEventQueue dispatches each event struct to the matching handler in FIFO order and
+ *   defers events pushed by a handler to the next drain.
  *
  * If any assertion fails, the test will abort, indicating an issue with the EventQueue implementation.
  */
 
 #include "event_queue/event_queue.hpp"
+#include "event_queue/typed_event_queue.hpp"
+#include "allocation_counter.hpp"
 #include <cassert>
 #include <iostream>
 #include <string>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
@@ -96,6 +135,740 @@ int main() {
         assert(counter == numThreads * eventsPerThread && "Counter should equal the total number of processed events.");
     }
     
+    // Test 4: Lock-free ring backend with concurrent producers and a concurrent consumer.
+    {
+        // A deliberately tiny ring forces producers to hit the "full" path.
+        EventQueue eq(EventQueue::Backend::LockFreeRing, 8);
+        assert(eq.backend() == EventQueue::Backend::LockFreeRing);
+        assert(eq.isEmpty() && "New ring-backed event queue should be empty.");
+
+        const int numThreads = 4;
+        const int eventsPerThread = 2000;
+        std::vector<int> lastSeen(numThreads, -1);
+        bool inOrder = true;
+        int processed = 0;
+        std::atomic<bool> producersDone{false};
+
+        std::thread consumer([&]() {
+            while (!producersDone.load() || !eq.isEmpty()) {
+                eq.processEvents();
+            }
+        });
+
+        std::vector<std::thread> producers;
+        for (int i = 0; i < numThreads; ++i) {
+            producers.emplace_back([&, i]() {
+                for (int j = 0; j < eventsPerThread; ++j) {
+                    // Only the consumer thread runs events, so no extra locking is needed.
+                    eq.pushEvent([&, i, j]() {
+                        if (lastSeen[i] + 1 != j) {
+                            inOrder = false;
+                        }
+                        lastSeen[i] = j;
+                        ++processed;
+                    });
+                }
+            });
+        }
+        for (auto &t : producers) {
+            t.join();
+        }
+        producersDone.store(true);
+        consumer.join();
+
+        assert(processed == numThreads * eventsPerThread && "Every pushed event should run exactly once.");
+        assert(inOrder && "Events from one producer should run in the order they were pushed.");
+        assert(eq.isEmpty() && "Ring-backed event queue should be empty after draining.");
+    }
+
+    // Test 5: Events that fit the inline buffer never touch the allocator from push to dispatch.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing}) {
+            EventQueue eq(backend, 64);
+            long sum = 0;
+            // Five pointers' worth of captures: too large for std::function's small buffer.
+            std::array<long, 5> payload{1, 2, 3, 4, 5};
+            static_assert(EventQueue::Event::fitsInline<decltype([&sum, payload]() {})>);
+
+            // Warm up the Mutex backend's storage so it has reached its working-set capacity.
+            for (int i = 0; i < 32; ++i) {
+                eq.pushEvent([]() {});
+            }
+            eq.processEvents();
+
+            const std::size_t before = allocationCount.load();
+            for (int i = 0; i < 32; ++i) {
+                eq.pushEvent([&sum, payload]() {
+                    for (long v : payload) {
+                        sum += v;
+                    }
+                });
+            }
+            eq.processEvents();
+            assert(allocationCount.load() == before && "Inline events should not allocate.");
+            assert(sum == 32 * 15 && "Every inline event should have run.");
+        }
+    }
+
+    // Test 6: Move-only and oversized callables, and emplaceEvent().
+    {
+        EventQueue eq;
+        int result = 0;
+
+        // A move-only capture cannot be stored in std::function but works here.
+        auto value = std::make_unique<int>(7);
+        eq.pushEvent([&result, value = std::move(value)]() {
+            result += *value;
+        });
+
+        // A callable larger than the inline buffer falls back to the heap transparently.
+        std::array<char, 256> big{};
+        big[0] = 3;
+        eq.pushEvent([&result, big]() {
+            result += big[0];
+        });
+        static_assert(!EventQueue::Event::fitsInline<std::array<char, 256>>);
+
+        // Construct the callable in place inside the event.
+        struct AddFive {
+            int *target;
+            void operator()() const { *target += 5; }
+        };
+        eq.emplaceEvent<AddFive>(&result);
+
+        eq.processEvents();
+        assert(result == 15 && "Move-only, oversized and emplaced events should all run.");
+
+        // Empty std::functions and null function pointers make empty events, which are skipped.
+        std::function<void()> none;
+        void (*null)() = nullptr;
+        assert(!EventQueue::Event(none) && !EventQueue::Event(std::function<void()>()));
+        assert(!EventQueue::Event(null) && "A null function pointer should make an empty event.");
+        eq.pushEvent(none);
+        eq.pushEvent(std::move(none));
+        eq.pushEvent(null);
+        eq.processEvents();
+        assert(eq.isEmpty() && "Empty events should be dropped without throwing.");
+    }
+
+    // Test 7: Batch drain defers events pushed during the drain to the next batch.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing}) {
+            EventQueue eq(backend, 64);
+            std::vector<int> order;
+
+            eq.pushEvent([&]() {
+                order.push_back(1);
+                // Pushed while the batch is running: must wait for the next batch.
+                eq.pushEvent([&order]() { order.push_back(3); });
+            });
+            eq.pushEvent([&order]() { order.push_back(2); });
+
+            eq.processEvents(EventQueue::DrainMode::Batch);
+            assert(order.size() == 2 && order[0] == 1 && order[1] == 2 &&
+                   "The first batch should only contain the events pending when it started.");
+            assert(!eq.isEmpty() && "The event pushed during the drain should still be queued.");
+
+            eq.processEvents(EventQueue::DrainMode::Batch);
+            assert(order.size() == 3 && order[2] == 3 && "The deferred event should run in the next batch.");
+            assert(eq.isEmpty() && "Event queue should be empty after the second batch.");
+        }
+
+        // Per-event draining keeps running events pushed by handlers until the queue is empty.
+        EventQueue eq;
+        int count = 0;
+        eq.pushEvent([&]() {
+            ++count;
+            eq.pushEvent([&count]() { ++count; });
+        });
+        eq.processEvents();
+        assert(count == 2 && eq.isEmpty() && "Per-event draining should run nested pushes too.");
+    }
+
+    // Test 8: Batch drains reuse their buffers, so the steady state does not allocate.
+    {
+        EventQueue eq;
+        int count = 0;
+        auto fill = [&]() {
+            for (int i = 0; i < 100; ++i) {
+                eq.pushEvent([&count]() { ++count; });
+            }
+        };
+        // Two warm-up rounds let both alternating buffers reach their working capacity.
+        for (int round = 0; round < 2; ++round) {
+            fill();
+            eq.processEvents(EventQueue::DrainMode::Batch);
+        }
+        const std::size_t before = allocationCount.load();
+        for (int round = 0; round < 10; ++round) {
+            fill();
+            eq.processEvents(EventQueue::DrainMode::Batch);
+        }
+        assert(allocationCount.load() == before && "Steady-state batch drains should not allocate.");
+        assert(count == 1200 && "Every event should run exactly once.");
+    }
+
+    // Test 9: Blocking consumer API.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing}) {
+            EventQueue eq(backend, 64);
+
+            // waitFor() on an empty queue times out and returns false.
+            const auto start = std::chrono::steady_clock::now();
+            assert(!eq.waitFor(std::chrono::milliseconds(20)) && "waitFor() should time out on an empty queue.");
+            assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20) &&
+                   "waitFor() should not return before the timeout.");
+
+            // waitFor() returns immediately when an event is already queued.
+            eq.pushEvent([]() {});
+            assert(eq.waitFor(std::chrono::seconds(5)) && "waitFor() should see a queued event.");
+            eq.processEvents();
+
+            // A parked consumer is woken by pushes from a producer thread.
+            const int numEvents = 100;
+            int processed = 0;
+            bool running = true;
+            std::thread consumer([&]() {
+                while (running) {
+                    eq.waitAndProcess();
+                }
+            });
+            for (int i = 0; i < numEvents; ++i) {
+                eq.pushEvent([&processed]() { ++processed; });
+                // Give the consumer time to park again between some of the pushes.
+                if (i % 10 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            // The last event stops the consumer loop; it runs on the consumer thread.
+            eq.pushEvent([&running]() { running = false; });
+            consumer.join();
+            assert(processed == numEvents && "The woken consumer should process every event.");
+            assert(eq.isEmpty() && "Event queue should be empty after the consumer exits.");
+        }
+    }
+
+    // Test 10: Strict priority lanes, FIFO within each lane, for every backend and drain mode.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing}) {
+            for (auto mode : {EventQueue::DrainMode::PerEvent, EventQueue::DrainMode::Batch}) {
+                EventQueue eq(backend, 64);
+                std::vector<int> order;
+                eq.pushEvent([&order]() { order.push_back(31); }, EventQueue::Priority::Low);
+                eq.pushEvent([&order]() { order.push_back(21); });
+                eq.pushEvent([&order]() { order.push_back(11); }, EventQueue::Priority::High);
+                eq.pushEvent([&order]() { order.push_back(32); }, EventQueue::Priority::Low);
+                eq.pushEvent([&order]() { order.push_back(22); }, EventQueue::Priority::Normal);
+                eq.pushEvent([&order]() { order.push_back(12); }, EventQueue::Priority::High);
+
+                eq.processEvents(mode);
+                const std::vector<int> expected{11, 12, 21, 22, 31, 32};
+                assert(order == expected && "Lanes should be served High, Normal, Low, each in FIFO order.");
+                assert(eq.isEmpty() && "All lanes should be empty after processing.");
+            }
+        }
+    }
+
+    // Test 11: Weighted dispatch lets every lane make progress according to its weight.
+    {
+        EventQueue::Options options;
+        options.dispatchPolicy = EventQueue::DispatchPolicy::Weighted;
+        options.laneWeights = {2, 1, 1};
+        EventQueue eq(options);
+        std::vector<int> order;
+        for (int i = 1; i <= 4; ++i) {
+            eq.pushEvent([&order, i]() { order.push_back(10 + i); }, EventQueue::Priority::High);
+        }
+        for (int i = 1; i <= 2; ++i) {
+            eq.pushEvent([&order, i]() { order.push_back(20 + i); }, EventQueue::Priority::Normal);
+            eq.pushEvent([&order, i]() { order.push_back(30 + i); }, EventQueue::Priority::Low);
+        }
+        eq.processEvents();
+        const std::vector<int> expected{11, 12, 21, 31, 13, 14, 22, 32};
+        assert(order == expected && "Weighted dispatch should interleave lanes by weight.");
+    }
+
+    // Test 12: Delayed, periodic and cancelled timers on a live queue.
+    {
+        using Clock = std::chrono::steady_clock;
+        EventQueue eq;
+        std::vector<int> order;
+        const auto start = Clock::now();
+        eq.scheduleAfter(std::chrono::milliseconds(20), [&order]() { order.push_back(2); });
+        eq.scheduleAt(start + std::chrono::milliseconds(10), [&order]() { order.push_back(1); });
+        const EventQueue::TimerId cancelled =
+            eq.scheduleAfter(std::chrono::milliseconds(5), [&order]() { order.push_back(-1); });
+        assert(eq.cancelTimer(cancelled) && "A pending timer should be cancellable.");
+        assert(!eq.cancelTimer(cancelled) && "A timer can only be cancelled once.");
+
+        int ticks = 0;
+        EventQueue::TimerId periodic;
+        periodic = eq.schedulePeriodic(std::chrono::milliseconds(2), [&]() {
+            if (++ticks == 3) {
+                eq.cancelTimer(periodic); // Cancelling from inside the timer's own event.
+            }
+        });
+        assert(eq.pendingTimers() == 3 && "Three timers should be pending.");
+        assert(eq.isEmpty() && "Timers do not occupy the event queue.");
+
+        // The blocking wait wakes up for the timers even though nothing is ever pushed.
+        while (order.size() < 2 || eq.pendingTimers() != 0) {
+            eq.waitAndProcess();
+        }
+        const std::vector<int> expected{1, 2};
+        assert(order == expected && "Timers should fire in expiry order, cancelled ones never.");
+        assert(ticks == 3 && "The periodic timer should stop once it cancels itself.");
+        assert(Clock::now() - start >= std::chrono::milliseconds(20) && "Timers must not fire early.");
+
+        // waitFor() returns as soon as a timer is due, well before its own timeout.
+        bool fired = false;
+        eq.scheduleAfter(std::chrono::milliseconds(5), [&fired]() { fired = true; });
+        const auto waitStart = Clock::now();
+        assert(eq.waitFor(std::chrono::seconds(10)) && "waitFor() should report a due timer.");
+        assert(Clock::now() - waitStart < std::chrono::seconds(5) && "The wait should end at the timer.");
+        eq.processEvents();
+        assert(fired && "processEvents() should run the due timer.");
+    }
+
+    // Test 13: The timing wheel fires every timer exactly once, never early, at every level.
+    {
+        using Wheel = TimingWheel<EventQueue::Event>;
+        const auto epoch = Wheel::Clock::time_point{};
+        Wheel wheel(std::chrono::milliseconds(1), epoch);
+        constexpr int numTimers = 20000;
+        std::vector<std::uint64_t> expiry(numTimers);
+        std::vector<int> firedAt(numTimers, -1);
+        std::vector<int> firedAfter(numTimers, -1);
+        std::vector<Wheel::Expired> expired;
+        std::uint64_t now = 0;
+        std::uint64_t previous = 0;
+        std::vector<TimerId> ids;
+        for (int i = 0; i < numTimers; ++i) {
+            // Spread delays over every level of the wheel (up to ~2^27 ticks).
+            expiry[i] = (static_cast<std::uint64_t>(i) * 2654435761u) % (std::uint64_t{1} << (i % 28));
+            ids.push_back(wheel.schedule(epoch + std::chrono::milliseconds(expiry[i]),
+                                         [&, i]() {
+                                             firedAt[i] = static_cast<int>(now);
+                                             firedAfter[i] = static_cast<int>(previous);
+                                         }));
+        }
+        for (int i = 0; i < numTimers; i += 2) {
+            assert(wheel.cancel(ids[i]) && "Cancelling a pending timer should succeed.");
+        }
+        assert(wheel.size() == numTimers / 2 && "Cancelled timers should be released.");
+        // Advance in uneven steps until every timer has fired.
+        std::uint64_t step = 1;
+        while (wheel.size() != 0) {
+            previous = now;
+            now += step;
+            step = step * 3 % 100003 + 1;
+            wheel.advance(epoch + std::chrono::milliseconds(now), expired);
+            for (auto &timer : expired) {
+                timer.callback();
+            }
+            expired.clear();
+        }
+        for (int i = 0; i < numTimers; ++i) {
+            if (i % 2 == 0) {
+                assert(firedAt[i] == -1 && "Cancelled timers must never fire.");
+            } else {
+                assert(firedAt[i] >= 0 && static_cast<std::uint64_t>(firedAt[i]) >= expiry[i] &&
+                       "Timers must fire, and never before their expiry.");
+                assert((expiry[i] == 0 || static_cast<std::uint64_t>(firedAfter[i]) < expiry[i]) &&
+                       "Timers must fire on the first advance that reaches their expiry.");
+            }
+        }
+        assert(!wheel.nextExpiry() && "An empty wheel has no next expiry.");
+    }
+
+    // Test 14: Bounded lanes and overflow policies.
+    {
+        const auto fill = [](EventQueue &eq, std::vector<int> &order, int count) {
+            int accepted = 0;
+            for (int i = 0; i < count; ++i) {
+                accepted += eq.pushEvent([&order, i]() { order.push_back(i); }) ? 1 : 0;
+            }
+            return accepted;
+        };
+        EventQueue::Options options;
+        options.capacity = 4;
+
+        options.overflowPolicy = EventQueue::OverflowPolicy::FailFast;
+        {
+            EventQueue eq(options);
+            std::vector<int> order;
+            assert(fill(eq, order, 6) == 4 && "FailFast should refuse pushes into a full lane.");
+            EventQueue::Event kept([&order]() { order.push_back(99); });
+            assert(!eq.tryPush(std::move(kept)) && "tryPush() should fail on a full lane.");
+            assert(kept && "A refused event stays with the caller.");
+            assert(eq.tryPush(std::move(kept), EventQueue::Priority::High) && "Lanes are bounded separately.");
+            assert(eq.overflowCounters().rejected == 3 && "Every refusal should be counted.");
+            eq.processEvents();
+            const std::vector<int> expected{99, 0, 1, 2, 3};
+            assert(order == expected && "Accepted events should run in order.");
+        }
+
+        options.overflowPolicy = EventQueue::OverflowPolicy::DropNewest;
+        {
+            EventQueue eq(options);
+            std::vector<int> order;
+            assert(fill(eq, order, 6) == 4 && "DropNewest should discard pushes into a full lane.");
+            assert(eq.overflowCounters().droppedNewest == 2 && "Discarded events should be counted.");
+            eq.processEvents();
+            const std::vector<int> expected{0, 1, 2, 3};
+            assert(order == expected && "The oldest events should be kept.");
+        }
+
+        options.overflowPolicy = EventQueue::OverflowPolicy::DropOldest;
+        {
+            EventQueue eq(options);
+            std::vector<int> order;
+            assert(fill(eq, order, 6) == 6 && "DropOldest always accepts the new event.");
+            assert(eq.overflowCounters().droppedOldest == 2 && "Evicted events should be counted.");
+            eq.processEvents(EventQueue::DrainMode::Batch);
+            const std::vector<int> expected{2, 3, 4, 5};
+            assert(order == expected && "The newest events should be kept.");
+
+            // The lanes were allocated up front: pushing, evicting and draining never allocate.
+            order.clear();
+            const std::size_t before = allocationCount.load();
+            for (int round = 0; round < 100; ++round) {
+                fill(eq, order, 10);
+                eq.processEvents(round % 2 == 0 ? EventQueue::DrainMode::Batch : EventQueue::DrainMode::PerEvent);
+                order.clear();
+            }
+            assert(allocationCount.load() == before && "A bounded queue should never reallocate.");
+
+            // A batch drain nested in a handler of another one runs in place, so the lanes keep
+            // their storage even though the outer drain holds the spare buffers.
+            const std::vector<int> nested{0, 2, 1};
+            const std::size_t beforeNested = allocationCount.load();
+            eq.pushEvent([&eq, &order]() {
+                order.push_back(0);
+                eq.pushEvent([&order]() { order.push_back(2); });
+                eq.processEvents(EventQueue::DrainMode::Batch);
+            });
+            eq.pushEvent([&order]() { order.push_back(1); });
+            eq.processEvents(EventQueue::DrainMode::Batch);
+            assert(order == nested && "The nested drain should run only the event pushed before it.");
+            for (int round = 0; round < 10; ++round) {
+                order.clear();
+                fill(eq, order, 10);
+                eq.processEvents(EventQueue::DrainMode::Batch);
+            }
+            assert(allocationCount.load() == beforeNested && "Overlapping batch drains should not reallocate.");
+        }
+
+        options.overflowPolicy = EventQueue::OverflowPolicy::Block;
+        {
+            EventQueue eq(options);
+            std::atomic<int> processed{0};
+            constexpr int numEvents = 1000;
+            std::thread producer([&]() {
+                for (int i = 0; i < numEvents; ++i) {
+                    eq.pushEvent([&processed]() { ++processed; });
+                }
+            });
+            while (processed < numEvents) {
+                eq.waitFor(std::chrono::milliseconds(1));
+                eq.processEvents();
+            }
+            producer.join();
+            assert(eq.overflowCounters().rejected == 0 && "Block should never lose events.");
+        }
+
+        options.backend = EventQueue::Backend::LockFreeRing;
+        options.overflowPolicy = EventQueue::OverflowPolicy::DropNewest;
+        {
+            EventQueue eq(options);
+            std::vector<int> order;
+            assert(fill(eq, order, 6) == 4 && "The ring backend should honour the capacity.");
+            assert(eq.overflowCounters().droppedNewest == 2 && "Ring drops should be counted.");
+        }
+        options.overflowPolicy = EventQueue::OverflowPolicy::DropOldest;
+        bool threw = false;
+        try {
+            EventQueue eq(options);
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw && "DropOldest cannot be combined with the lock-free ring.");
+
+        // Block on the lock-free backends: producers sleep on a full ring instead of spinning.
+        options.overflowPolicy = EventQueue::OverflowPolicy::Block;
+        for (const bool sharded : {false, true}) {
+            options.backend = sharded ? EventQueue::Backend::ShardedSpsc : EventQueue::Backend::LockFreeRing;
+            EventQueue eq(options);
+            std::atomic<int> processed{0};
+            constexpr int numEvents = 1000;
+            std::atomic<bool> started{false};
+            std::atomic<int> refused{0};
+            std::thread producer([&]() {
+                std::optional<EventQueue::Producer> lane;
+                if (sharded) {
+                    lane.emplace(eq.registerProducer());
+                }
+                started = true;
+                for (int i = 0; i < numEvents; ++i) {
+                    EventQueue::Event event([&processed]() { ++processed; });
+                    if (!(lane ? lane->push(std::move(event)) : eq.pushEvent(std::move(event)))) {
+                        ++refused;
+                    }
+                }
+            });
+            while (!started) {
+                std::this_thread::yield();
+            }
+            // The producer fills the ring and then parks; a spinning producer would burn the
+            // whole pause in CPU time.
+            const std::clock_t cpuBefore = std::clock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            const double cpuSeconds = static_cast<double>(std::clock() - cpuBefore) / CLOCKS_PER_SEC;
+            assert(cpuSeconds < 0.1 && "A blocked producer should sleep, not spin.");
+            while (processed < numEvents) {
+                eq.waitFor(std::chrono::milliseconds(1));
+                eq.processEvents();
+            }
+            producer.join();
+            assert(refused == 0 && "Block should never refuse an event.");
+        }
+    }
+
+    // Test 15: TypedEventQueue dispatches event structs to the matching handlers.
+    {
+        struct Started {
+            int id;
+        };
+        struct Message {
+            std::string text;
+        };
+        TypedEventQueue<Started, Message> eq;
+        assert(eq.isEmpty() && "A new typed queue should be empty.");
+        std::vector<std::string> log;
+        eq.pushEvent(Started{1});
+        eq.pushEvent(Message{"hello"});
+        eq.emplaceEvent<Started>(2);
+        assert(eq.size() == 3 && "Three events should be pending.");
+
+        const auto visitor = Overloaded{
+            [&](const Started &event) {
+                log.push_back("started " + std::to_string(event.id));
+                if (event.id == 2) {
+                    eq.pushEvent(Message{"deferred"});
+                }
+            },
+            [&](const Message &event) { log.push_back(event.text); },
+        };
+        assert(eq.processEvents(visitor) == 3 && "Every pending event should be dispatched.");
+        const std::vector<std::string> expected{"started 1", "hello", "started 2"};
+        assert(log == expected && "Events should reach their handlers in FIFO order.");
+        assert(eq.size() == 1 && "An event pushed by a handler waits for the next drain.");
+        assert(eq.processEvents(visitor) == 1 && log.back() == "deferred" && "The next drain runs it.");
+        assert(eq.isEmpty() && "The typed queue should be empty after draining.");
+    }
+
+    // Test 16: Per-producer SPSC lanes.
+    {
+        // Concurrent producers, each with its own ring, and a concurrent consumer.
+        EventQueue::Options options;
+        options.backend = EventQueue::Backend::ShardedSpsc;
+        options.ringCapacity = 256; // Small rings so that producers also hit the full case.
+        EventQueue eq(options);
+        constexpr int numProducers = 4;
+        constexpr int eventsPerProducer = 20000;
+        std::array<int, numProducers> lastSeen;
+        lastSeen.fill(-1);
+        std::atomic<int> processed{0};
+        bool ordered = true;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < numProducers; ++p) {
+            producers.emplace_back([&, p]() {
+                EventQueue::Producer producer = eq.registerProducer();
+                for (int i = 0; i < eventsPerProducer; ++i) {
+                    producer.push([&, p, i]() {
+                        ordered = ordered && lastSeen[p] == i - 1;
+                        lastSeen[p] = i;
+                        ++processed;
+                    });
+                }
+            });
+        }
+        eq.pushEvent([&processed]() { ++processed; }); // Unregistered pushes still work.
+        while (processed < numProducers * eventsPerProducer + 1) {
+            eq.processEvents();
+        }
+        for (auto &t : producers) {
+            t.join();
+        }
+        assert(ordered && "Each producer's events should run in FIFO order.");
+        assert(eq.isEmpty() && "All rings should be empty after processing.");
+
+        // Global sequence: events from different producers run in push order.
+        options.producerOrdering = EventQueue::ProducerOrdering::GlobalSequence;
+        options.maxProducers = 2;
+        EventQueue sequenced(options);
+        EventQueue::Producer a = sequenced.registerProducer();
+        EventQueue::Producer b = sequenced.registerProducer();
+        std::vector<int> order;
+        a.push([&order]() { order.push_back(1); });
+        b.push([&order]() { order.push_back(2); });
+        b.push([&order]() { order.push_back(3); });
+        a.push([&order]() { order.push_back(4); });
+        b.push([&order]() { order.push_back(5); });
+        sequenced.processEvents();
+        const std::vector<int> expected{1, 2, 3, 4, 5};
+        assert(order == expected && "GlobalSequence should merge producers in push order.");
+
+        bool threw = false;
+        try {
+            sequenced.registerProducer();
+        } catch (const std::length_error &) {
+            threw = true;
+        }
+        assert(threw && "Registering more than maxProducers producers should fail.");
+        threw = false;
+        try {
+            EventQueue mutexQueue;
+            mutexQueue.registerProducer();
+        } catch (const std::logic_error &) {
+            threw = true;
+        }
+        assert(threw && "Only the sharded backend accepts registered producers.");
+    }
+
+    // Test 17: Keyed coalescing.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing}) {
+            for (auto mode : {EventQueue::DrainMode::PerEvent, EventQueue::DrainMode::Batch}) {
+                EventQueue eq(backend, 64);
+                std::vector<std::string> log;
+                eq.pushEvent([&log]() { log.push_back("first"); });
+                for (int i = 0; i < 50; ++i) {
+                    eq.pushCoalesced(1, [&log, i]() { log.push_back("refresh " + std::to_string(i)); });
+                    if (i == 0) {
+                        eq.pushEvent([&log]() { log.push_back("middle"); });
+                    }
+                }
+                eq.pushCoalesced(2, [&log]() {
+                    log.push_back("other key");
+                });
+                eq.processEvents(mode);
+                const std::vector<std::string> expected{"first", "refresh 49", "middle", "other key"};
+                assert(log == expected && "Only the latest event per key should run, at the first one's position.");
+
+                eq.pushCoalesced(1, [&log]() { log.push_back("again"); });
+                eq.processEvents(mode);
+                assert(log.back() == "again" && "A key whose event has run should be usable again.");
+            }
+        }
+
+        // A coalesced event dropped by a bounded queue releases its key.
+        EventQueue::Options options;
+        options.capacity = 1;
+        options.overflowPolicy = EventQueue::OverflowPolicy::DropOldest;
+        EventQueue eq(options);
+        std::vector<std::string> log;
+        eq.pushCoalesced(7, [&log]() { log.push_back("evicted"); });
+        eq.pushEvent([&log]() { log.push_back("plain"); });
+        eq.pushCoalesced(7, [&log]() { log.push_back("latest"); });
+        eq.processEvents();
+        const std::vector<std::string> expected{"latest"};
+        assert(log == expected && "An evicted coalesced event should not block its key.");
+    }
+
+    // Test 18: Count- and time-budgeted processing.
+    {
+        for (auto backend : {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing}) {
+            EventQueue eq(backend, 64);
+            int ran = 0;
+            for (int i = 0; i < 10; ++i) {
+                eq.pushEvent([&ran]() { ++ran; });
+            }
+            EventQueue::ProcessResult result = eq.processUpTo(3);
+            assert(result.processed == 3 && result.remaining == 7 && ran == 3 && "processUpTo() should stop at the count.");
+            result = eq.processUpTo(100);
+            assert(result.processed == 7 && result.remaining == 0 && ran == 10 && "The rest should run next time.");
+        }
+
+        // A handler that always re-pushes itself keeps the queue busy forever.
+        using Clock = std::chrono::steady_clock;
+        EventQueue::Options options;
+        options.deadlineCheckInterval = 1;
+        EventQueue eq(options);
+        std::function<void()> spin = [&]() {
+            const auto until = Clock::now() + std::chrono::microseconds(100);
+            while (Clock::now() < until) {
+            }
+            eq.pushEvent([&spin]() { spin(); });
+        };
+        eq.pushEvent([&spin]() { spin(); });
+        const auto start = Clock::now();
+        const EventQueue::ProcessResult result = eq.processFor(std::chrono::milliseconds(5));
+        const auto elapsed = Clock::now() - start;
+        assert(result.processed > 0 && result.remaining == 1 && "processFor() should stop with work left.");
+        assert(elapsed < std::chrono::milliseconds(50) && "processFor() should return close to its deadline.");
+    }
+
+    // Test 19: Arena-backed payload events.
+    {
+        EventQueue eq;
+        std::vector<std::byte> payload(1000);
+        std::size_t received = 0;
+        bool intact = true;
+        auto pushRound = [&](int round) {
+            for (int i = 0; i < 200; ++i) {
+                for (std::size_t b = 0; b < payload.size(); ++b) {
+                    payload[b] = static_cast<std::byte>(round + i + b);
+                }
+                const bool pushed = eq.pushPayloadEvent(payload, [&, round, i](std::span<const std::byte> data) {
+                    ++received;
+                    for (std::size_t b = 0; b < data.size(); ++b) {
+                        intact = intact && data[b] == static_cast<std::byte>(round + i + b);
+                    }
+                });
+                assert(pushed && "A payload event should be accepted.");
+            }
+        };
+
+        pushRound(0);
+        PayloadArena::Stats stats = eq.payloadStats();
+        assert(stats.liveAllocations == 200 && stats.liveBytes == 200 * payload.size() && "Queued payloads should be live.");
+        assert(stats.chunks >= 3 && stats.fragmentation() < 0.25 && "Payloads should be packed into chunks.");
+        eq.processEvents();
+        assert(received == 200 && intact && "Every handler should see its own payload bytes.");
+        stats = eq.payloadStats();
+        assert(stats.liveAllocations == 0 && stats.liveBytes == 0 && "A drained batch should free its payloads.");
+        const std::size_t chunks = stats.chunks;
+
+        // Later rounds reuse the reclaimed chunks instead of allocating.
+        const std::size_t before = allocationCount.load();
+        for (int round = 1; round <= 5; ++round) {
+            pushRound(round);
+            eq.processEvents();
+        }
+        assert(allocationCount.load() == before && "Steady-state payload events should not allocate.");
+        assert(received == 1200 && intact && eq.payloadStats().chunks == chunks && "Chunks should be reused.");
+
+        // Oversized payloads go to the upstream resource and are freed the same way.
+        std::vector<std::byte> large(PayloadArena::kMaxSmallAllocation + 1, std::byte{7});
+        std::size_t largeSize = 0;
+        eq.pushPayloadEvent(large, [&largeSize](std::span<const std::byte> data) { largeSize = data.size(); });
+        assert(eq.payloadStats().upstreamAllocations == 1 && "A large payload should bypass the chunks.");
+        eq.processEvents();
+        assert(largeSize == large.size() && eq.payloadStats().liveAllocations == 0);
+
+        // The arena also backs std::pmr containers, and trim() hands unused chunks back.
+        {
+            std::pmr::vector<int> values(100, 1, eq.payloadResource());
+            assert(eq.payloadStats().liveAllocations == 1);
+        }
+        PayloadArena arena;
+        void *p = arena.allocate(64);
+        arena.deallocate(p, 64);
+        arena.trim();
+        assert(arena.stats().chunks == 0 && "trim() should release unused chunks.");
+    }
+
     std::cout << "All event queue tests passed." << std::endl;
     return 0;
 }
@@ -0,0 +1,141 @@
+/**
+ * @file executor_test.cpp
+ * @brief Unit tests for the Executor class.
+ *
+ * This file contains unit tests for the work-stealing Executor to verify that:
+ * - Every submitted event runs exactly once and shutdown() drains pending work.
+ * - Events run concurrently on different workers.
+ * - Idle workers steal events that were queued on another worker.
+ * - ShutdownMode::Discard drops queued events and later submits are rejected.
+ * - An event whose submit() returned true runs even when the submit races with shutdown().
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the Executor implementation.
+ */
+
+#include "event_queue/executor.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <latch>
+#include <thread>
+#include <vector>
+
+using namespace event_queue;
+
+int main() {
+    // Test 1: All events run exactly once; shutdown() drains, including nested submits.
+    {
+        Executor executor(4);
+        assert(executor.workerCount() == 4 && "Executor should start the requested number of workers.");
+
+        std::atomic<int> counter{0};
+        const int numEvents = 1000;
+        for (int i = 0; i < numEvents; ++i) {
+            executor.submit([&counter, &executor]() {
+                counter.fetch_add(1);
+                // Follow-up work submitted by a handler must also run before shutdown returns.
+                executor.submit([&counter]() { counter.fetch_add(1); });
+            });
+        }
+        executor.shutdown();
+        assert(counter.load() == 2 * numEvents && "Every event and nested event should run exactly once.");
+        assert(!executor.submit([]() {}) && "submit() should be rejected after shutdown().");
+    }
+
+    // Test 2: Events submitted from outside run concurrently on different workers.
+    {
+        const int numWorkers = 4;
+        Executor executor(numWorkers);
+        // Each event blocks until all of them are running at the same time.
+        std::latch allRunning(numWorkers);
+        std::atomic<int> done{0};
+        for (int i = 0; i < numWorkers; ++i) {
+            executor.submit([&]() {
+                allRunning.arrive_and_wait();
+                done.fetch_add(1);
+            });
+        }
+        executor.shutdown();
+        assert(done.load() == numWorkers && "Events should run concurrently on all workers.");
+    }
+
+    // Test 3: Work queued on one worker is stolen by the idle ones.
+    {
+        const int numWorkers = 4;
+        Executor executor(numWorkers);
+        std::latch allRunning(numWorkers);
+        std::atomic<int> done{0};
+        executor.submit([&]() {
+            // Nested submits all land on this worker's own queue...
+            for (int i = 0; i < numWorkers - 1; ++i) {
+                executor.submit([&]() {
+                    allRunning.arrive_and_wait();
+                    done.fetch_add(1);
+                });
+            }
+            // ...and this worker blocks, so only stealing can complete the latch.
+            allRunning.arrive_and_wait();
+            done.fetch_add(1);
+        });
+        executor.shutdown();
+        assert(done.load() == numWorkers && "Idle workers should steal queued events.");
+    }
+
+    // Test 4: Discarding shutdown drops queued events.
+    {
+        Executor executor(1);
+        std::atomic<bool> release{false};
+        std::atomic<int> ran{0};
+        // Occupy the only worker so the following events stay queued.
+        executor.submit([&release]() {
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        for (int i = 0; i < 10; ++i) {
+            executor.submit([&ran]() { ran.fetch_add(1); });
+        }
+        std::thread stopper([&executor]() { executor.shutdown(Executor::ShutdownMode::Discard); });
+        // Wait until shutdown has started (submits are rejected), then unblock the worker.
+        while (executor.submit([]() {})) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release.store(true);
+        stopper.join();
+        assert(ran.load() == 0 && "Queued events should be discarded by ShutdownMode::Discard.");
+    }
+
+    // Test 5: An event whose submit() returned true runs, also when it races with shutdown().
+    {
+        constexpr int kRounds = 200;
+        constexpr int kSubmitters = 4;
+        for (int round = 0; round < kRounds; ++round) {
+            Executor executor(2);
+            std::atomic<int> accepted{0};
+            std::atomic<int> ran{0};
+            std::latch start(kSubmitters + 1);
+            std::vector<std::thread> submitters;
+            for (int t = 0; t < kSubmitters; ++t) {
+                submitters.emplace_back([&]() {
+                    start.arrive_and_wait();
+                    for (int i = 0; i < 50; ++i) {
+                        if (executor.submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); })) {
+                            accepted.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                });
+            }
+            start.arrive_and_wait();
+            executor.shutdown();
+            for (auto &submitter : submitters) {
+                submitter.join();
+            }
+            assert(ran.load() == accepted.load() && "An accepted event must not be dropped.");
+        }
+    }
+
+    std::cout << "All executor tests passed." << std::endl;
+    return 0;
+}
@@ -7,13 +7,21 @@
  * - Observers are notified when the subject sends an event.
  * - Multiple observers receive the notification.
  * - Removing an observer prevents it from receiving subsequent notifications.
+ * - Destroying, resetting or moving a Subscription removes or transfers the registration,
+ *   also from inside onNotify() and after the subject is gone, and detached observers stay
+ *   registered.
+ * - Subjects of structured events (a struct, a std::variant) pass the event itself to every
+ *   observer by reference.
  *
  * If any assertion fails, the test will abort, indicating an issue with the implementation.
  */
 
 #include <cassert>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 #include "observer/observer.hpp"
 #include "observer/subject.hpp"
@@ -52,6 +60,68 @@ private:
     std::vector<std::string> messages; ///< Container to store received notification messages.
 };
 
+/**
+ * @brief A structured event.
+ */
+struct PriceUpdate {
+    int instrument; ///< Instrument identifier.
+    double price;   ///< New price.
+};
+
+/**
+ * @brief Another structured event, for the variant subject.
+ */
+struct TradeHalted {
+    int instrument; ///< Instrument identifier.
+};
+
+using MarketEvent = std::variant<PriceUpdate, TradeHalted>;
+
+/**
+ * @brief An observer of PriceUpdate events that remembers the last event and its address.
+ */
+class PriceObserver : public BasicObserver<PriceUpdate> {
+public:
+    void onNotify(const PriceUpdate &event) override {
+        last = event;
+        lastAddress = &event;
+    }
+
+    PriceUpdate last{0, 0.0};                 ///< Last event received.
+    const PriceUpdate *lastAddress = nullptr; ///< Address of the last event received.
+};
+
+/**
+ * @brief An observer of MarketEvent variants that counts halts and sums prices.
+ */
+class MarketObserver : public BasicObserver<MarketEvent> {
+public:
+    void onNotify(const MarketEvent &event) override {
+        if (const auto *update = std::get_if<PriceUpdate>(&event)) {
+            priceSum += update->price;
+        } else {
+            ++halts;
+        }
+    }
+
+    double priceSum = 0.0; ///< Sum of the prices received.
+    int halts = 0;         ///< Number of halts received.
+};
+
+/**
+ * @brief An observer that ends its own subscription when notified.
+ */
+class OneShotObserver : public IObserver {
+public:
+    void onNotify(const std::string &message) override {
+        messages.push_back(message);
+        subscription.unsubscribe();
+    }
+
+    Subscription subscription;         ///< This observer's registration.
+    std::vector<std::string> messages; ///< Received messages.
+};
+
 int main() {
     // Create a Subject instance.
     Subject subject;
@@ -60,9 +130,9 @@ int main() {
     TestObserver observer1;
     TestObserver observer2;
 
-    // Register both observers with the subject.
-    subject.addObserver(&observer1);
-    subject.addObserver(&observer2);
+    // Register both observers with the subject, keeping their subscriptions alive.
+    Subscription subscription1 = subject.addObserver(&observer1);
+    Subscription subscription2 = subject.addObserver(&observer2);
 
     // Define a test message and notify all observers.
     std::string testMessage = "Test Event";
@@ -90,6 +160,90 @@ int main() {
     assert(observer2.getMessages().size() == 2 && "Observer2 should have received two messages.");
     assert(observer2.getMessages()[1] == newMessage && "Observer2's second message should match the new test event.");
 
+    // Destroying a subscription removes its observer.
+    {
+        TestObserver scoped;
+        {
+            Subscription subscription = subject.addObserver(&scoped);
+            assert(subscription.isActive());
+            assert(subject.observerCount() == 2);
+        }
+        assert(subject.observerCount() == 1 && "Destroying the subscription should remove the observer.");
+        subject.notify("After scope");
+        assert(scoped.getMessages().empty());
+    }
+
+    // Observers that unsubscribe during a notification do not make others miss it.
+    {
+        Subject fanout;
+        std::vector<std::unique_ptr<OneShotObserver>> oneShots;
+        std::vector<std::unique_ptr<TestObserver>> regulars;
+        std::vector<Subscription> subscriptions;
+        for (int i = 0; i < 10; ++i) {
+            oneShots.push_back(std::make_unique<OneShotObserver>());
+            oneShots.back()->subscription = fanout.addObserver(oneShots.back().get());
+            regulars.push_back(std::make_unique<TestObserver>());
+            subscriptions.push_back(fanout.addObserver(regulars.back().get()));
+        }
+        fanout.notify("Once");
+        fanout.notify("Twice");
+        for (const auto &oneShot : oneShots) {
+            assert(oneShot->messages.size() == 1 && "A one-shot observer should be notified exactly once.");
+            assert(!oneShot->subscription.isActive());
+        }
+        for (const auto &regular : regulars) {
+            assert(regular->getMessages().size() == 2 && "No observer should be skipped by a removal.");
+        }
+        assert(fanout.observerCount() == 10);
+
+        // Moving a subscription transfers the registration.
+        Subscription moved = std::move(subscriptions.front());
+        assert(moved.isActive() && !subscriptions.front().isActive());
+        moved = Subscription{};
+        fanout.notify("Third");
+        assert(regulars.front()->getMessages().size() == 2 && "Replacing a subscription should end it.");
+        assert(fanout.observerCount() == 9);
+    }
+
+    // Detached observers stay registered; subscriptions may outlive their subject.
+    {
+        TestObserver detached;
+        Subscription survivor;
+        {
+            Subject shortLived;
+            shortLived.addObserver(&detached).detach();
+            survivor = shortLived.addObserver(&observer2);
+            shortLived.notify("Detached");
+            assert(detached.getMessages().size() == 1);
+            shortLived.removeObserver(&detached);
+            assert(shortLived.observerCount() == 1);
+        }
+        assert(!survivor.isActive());
+        survivor.unsubscribe(); // The subject is gone; this must be a no-op.
+    }
+
+    // Structured events reach the observers by reference.
+    {
+        BasicSubject<PriceUpdate> prices;
+        PriceObserver first;
+        PriceObserver second;
+        Subscription firstSubscription = prices.addObserver(&first);
+        Subscription secondSubscription = prices.addObserver(&second);
+        const PriceUpdate update{7, 101.5};
+        prices.notify(update);
+        assert(first.last.instrument == 7 && first.last.price == 101.5);
+        assert(first.lastAddress == &update && second.lastAddress == &update &&
+               "Every observer should see the published event itself, not a copy.");
+
+        BasicSubject<MarketEvent> market;
+        MarketObserver observer;
+        Subscription marketSubscription = market.addObserver(&observer);
+        market.notify(PriceUpdate{1, 2.5});
+        market.notify(TradeHalted{1});
+        market.notify(PriceUpdate{1, 3.5});
+        assert(observer.priceSum == 6.0 && observer.halts == 1);
+    }
+
     std::cout << "All observer tests passed." << std::endl;
     return 0;
 }
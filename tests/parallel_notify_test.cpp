@@ -0,0 +1,163 @@
+/**
+ * @file parallel_notify_test.cpp
+ * @brief Unit tests for BasicSubject::notifyParallel().
+ *
+ * This file contains unit tests for parallel fan-out notification to verify that:
+ * - Lists at or below the sequential threshold are notified on the calling thread, and the
+ *   returned future is ready at once.
+ * - Large lists are split into chunks that run on the pool's workers, every observer is
+ *   notified exactly once, and the event outlives the call.
+ * - An exception thrown by an observer reaches the future without stopping the other chunks.
+ * - Chunks a shut-down pool refuses are run on the calling thread.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the parallel notification.
+ */
+
+#include "event_queue/executor.hpp"
+#include "observer/subject.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace observer;
+
+namespace {
+
+struct Order {
+    int id;               ///< Order identifier.
+    std::vector<int> legs; ///< Heap-allocated part, to check that the event is copied.
+};
+
+/**
+ * @brief Counts its notifications and remembers the thread it last ran on.
+ */
+class CountingObserver : public BasicObserver<Order> {
+public:
+    void onNotify(const Order &event) override {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        legSum.fetch_add(event.legs.size(), std::memory_order_relaxed);
+        thread = std::this_thread::get_id();
+    }
+
+    std::atomic<int> calls{0};            ///< Number of notifications.
+    std::atomic<std::size_t> legSum{0};   ///< Sum of the events' leg counts.
+    std::thread::id thread;               ///< Thread of the last notification.
+};
+
+/**
+ * @brief Throws from onNotify().
+ */
+class ThrowingObserver : public BasicObserver<Order> {
+public:
+    void onNotify(const Order &) override { throw std::runtime_error("observer failed"); }
+};
+
+/**
+ * @brief Registers @p count counting observers with @p subject.
+ */
+std::vector<std::unique_ptr<CountingObserver>> subscribeMany(BasicSubject<Order> &subject, std::size_t count,
+                                                             std::vector<Subscription> &subscriptions) {
+    std::vector<std::unique_ptr<CountingObserver>> observers;
+    for (std::size_t i = 0; i < count; ++i) {
+        observers.push_back(std::make_unique<CountingObserver>());
+        subscriptions.push_back(subject.addObserver(observers.back().get()));
+    }
+    return observers;
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Small lists are notified inline.
+    {
+        event_queue::Executor executor(2);
+        BasicSubject<Order> subject;
+        std::vector<Subscription> subscriptions;
+        auto observers = subscribeMany(subject, 100, subscriptions);
+        std::future<void> done = subject.notifyParallel(Order{1, {1, 2}}, executor);
+        assert(done.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        done.get();
+        for (const auto &observer : observers) {
+            assert(observer->calls.load() == 1);
+            assert(observer->thread == std::this_thread::get_id() && "Small lists should run on the caller.");
+        }
+    }
+
+    // Test 2: Large lists are split over the pool.
+    {
+        event_queue::Executor executor(4);
+        BasicSubject<Order> subject;
+        std::vector<Subscription> subscriptions;
+        auto observers = subscribeMany(subject, 10000, subscriptions);
+        ParallelNotifyOptions options;
+        options.chunkSize = 100;
+        options.sequentialThreshold = 500;
+        std::future<void> first;
+        {
+            Order order{2, {1, 2, 3}};
+            first = subject.notifyParallel(order, executor, options);
+        } // The event goes out of scope while chunks may still be running.
+        std::future<void> second = subject.notifyParallel(Order{3, {1}}, executor, options);
+        first.get();
+        second.get();
+        std::size_t onWorkers = 0;
+        for (const auto &observer : observers) {
+            assert(observer->calls.load() == 2 && "Every observer should be notified once per call.");
+            assert(observer->legSum.load() == 4 && "Observers should see intact copies of the events.");
+            onWorkers += observer->thread != std::this_thread::get_id() ? 1 : 0;
+        }
+        assert(onWorkers > 0 && "Some chunks should run on the pool's workers.");
+    }
+
+    // Test 3: Exceptions reach the future; other chunks still run.
+    {
+        event_queue::Executor executor(2);
+        BasicSubject<Order> subject;
+        std::vector<Subscription> subscriptions;
+        auto observers = subscribeMany(subject, 2000, subscriptions);
+        ThrowingObserver thrower;
+        Subscription throwing = subject.addObserver(&thrower); // The last chunk.
+        ParallelNotifyOptions options;
+        options.chunkSize = 64;
+        options.sequentialThreshold = 0;
+        std::future<void> done = subject.notifyParallel(Order{4, {}}, executor, options);
+        bool threw = false;
+        try {
+            done.get();
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && "The observer's exception should be delivered through the future.");
+        for (const auto &observer : observers) {
+            assert(observer->calls.load() == 1 && "Chunks without a throwing observer should complete.");
+        }
+    }
+
+    // Test 4: A shut-down pool runs nothing; the caller does all the work.
+    {
+        event_queue::Executor executor(2);
+        executor.shutdown();
+        BasicSubject<Order> subject;
+        std::vector<Subscription> subscriptions;
+        auto observers = subscribeMany(subject, 3000, subscriptions);
+        ParallelNotifyOptions options;
+        options.chunkSize = 128;
+        options.sequentialThreshold = 0;
+        subject.notifyParallel(Order{5, {1}}, executor, options).get();
+        for (const auto &observer : observers) {
+            assert(observer->calls.load() == 1);
+            assert(observer->thread == std::this_thread::get_id());
+        }
+    }
+
+    std::cout << "All parallel notify tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file shm_channel_test.cpp
+ * @brief Unit tests for the ShmChannel class.
+ *
+ * This file contains unit tests for the cross-process shared-memory channel to verify that:
+ * - Records pushed by one side are processed by the other in order, with their types and
+ *   payloads intact, also when they wrap around the end of the ring, and waitAndProcess()
+ *   returns false once the channel is closed and drained.
+ * - A full ring refuses pushes until the consumer frees space, and oversized records are refused.
+ * - A producer in a forked child process can stream events to a parent, including to a
+ *   consumer that is asleep, and closing the channel ends the parent's wait loop.
+ * - Attaching to a missing channel fails and creating an existing one fails.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the ShmChannel implementation.
+ */
+
+#include "event_queue/shm_channel.hpp"
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace event_queue;
+
+namespace {
+
+struct Tick {
+    std::uint64_t sequence;
+    std::uint64_t checksum;
+};
+
+std::string channelName(const char *suffix) {
+    return "/shm_channel_test_" + std::to_string(::getpid()) + "_" + suffix;
+}
+
+Tick readTick(const ShmChannel::Message &message) {
+    assert(message.payload.size() == sizeof(Tick));
+    Tick tick;
+    std::memcpy(&tick, message.payload.data(), sizeof(tick));
+    return tick;
+}
+
+} // namespace
+
+int main() {
+    // Test 1: In-order delivery of variable-sized records, with wrap-around.
+    {
+        ShmChannel::Options options;
+        options.capacity = 1024;
+        ShmChannel consumer(channelName("order"), ShmChannel::OpenMode::Create, options);
+        ShmChannel producer(channelName("order"), ShmChannel::OpenMode::Open);
+        assert(producer.capacity() == 1024 && "The opener should see the creator's capacity.");
+
+        std::uint32_t nextExpected = 0;
+        std::uint32_t pushed = 0;
+        for (int round = 0; round < 200; ++round) {
+            // Sizes 0..99 bytes, so record boundaries land everywhere in the ring.
+            for (int i = 0; i < 3; ++i, ++pushed) {
+                std::vector<std::byte> payload(pushed % 100, static_cast<std::byte>(pushed));
+                assert(producer.pushEvent(pushed, payload));
+            }
+            assert(consumer.waitAndProcess([&](const ShmChannel::Message &message) {
+                assert(message.type == nextExpected && "Records should arrive in push order.");
+                assert(message.payload.size() == nextExpected % 100);
+                for (std::byte b : message.payload) {
+                    assert(b == static_cast<std::byte>(nextExpected) && "Payloads should be intact.");
+                }
+                ++nextExpected;
+            }));
+        }
+        assert(nextExpected == pushed && consumer.isEmpty());
+        producer.close();
+        assert(!consumer.waitAndProcess([](const ShmChannel::Message &) {}) &&
+               "waitAndProcess() should return false once the channel is closed and drained.");
+    }
+
+    // Test 2: A full ring refuses pushes; oversized records throw.
+    {
+        ShmChannel::Options options;
+        options.capacity = 256;
+        ShmChannel channel(channelName("full"), ShmChannel::OpenMode::Create, options);
+        int accepted = 0;
+        while (channel.pushEvent(1, Tick{static_cast<std::uint64_t>(accepted), 0})) {
+            ++accepted;
+        }
+        assert(accepted == 256 / 24 && "A 24-byte record should fit capacity / 24 times.");
+        assert(channel.processEvents([](const ShmChannel::Message &) {}) == static_cast<std::size_t>(accepted));
+        assert(channel.pushEvent(1, Tick{0, 0}) && "Processing should free space.");
+
+        bool threw = false;
+        try {
+            std::vector<std::byte> large(channel.maxPayloadSize() + 1);
+            channel.pushEvent(2, large);
+        } catch (const std::length_error &) {
+            threw = true;
+        }
+        assert(threw && "A record larger than maxPayloadSize() should be refused.");
+    }
+
+    // Test 3: A forked producer streams to a parent consumer, which sleeps in between.
+    {
+        constexpr std::uint64_t kEvents = 200000;
+        ShmChannel::Options options;
+        options.capacity = 64 * 1024;
+        options.spinCount = 16; // Make the consumer go to sleep often.
+        const std::string name = channelName("fork"); // Before fork(): the child has another pid.
+        ShmChannel consumer(name, ShmChannel::OpenMode::Create, options);
+
+        const pid_t child = ::fork();
+        assert(child >= 0);
+        if (child == 0) {
+            int status = 0;
+            {
+                ShmChannel producer(name, ShmChannel::OpenMode::Open);
+                // Let the parent fall asleep before the first event.
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                for (std::uint64_t i = 0; i < kEvents; ++i) {
+                    while (!producer.pushEvent(7, Tick{i, i * 2654435761u})) {
+                        std::this_thread::yield();
+                    }
+                    if (i % 50000 == 0) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    }
+                }
+                producer.close();
+                status = producer.pushEvent(7, Tick{0, 0}) ? 1 : 0; // Must fail after close().
+            }
+            ::_exit(status); // Skip the parent's destructors (and its unlink of the name).
+        }
+
+        assert(!consumer.waitFor(std::chrono::milliseconds(1)) && "Nothing should arrive this early.");
+        std::uint64_t expected = 0;
+        // Bounded waits, so that a failing child cannot hang the test.
+        while (consumer.waitFor(std::chrono::seconds(10))) {
+            consumer.processEvents([&](const ShmChannel::Message &message) {
+                const Tick tick = readTick(message);
+                assert(message.type == 7 && tick.sequence == expected && tick.checksum == expected * 2654435761u);
+                ++expected;
+            });
+        }
+        assert(expected == kEvents && "Every event should cross the process boundary.");
+        assert(consumer.isClosed());
+
+        int status = 0;
+        assert(::waitpid(child, &status, 0) == child);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0 && "The producer process should succeed.");
+    }
+
+    // Test 4: Opening a missing channel and creating an existing one fail.
+    {
+        bool threw = false;
+        try {
+            ShmChannel missing(channelName("missing"), ShmChannel::OpenMode::Open);
+        } catch (const std::system_error &) {
+            threw = true;
+        }
+        assert(threw && "Opening a missing channel should throw.");
+
+        ShmChannel first(channelName("twice"), ShmChannel::OpenMode::Create);
+        threw = false;
+        try {
+            ShmChannel second(channelName("twice"), ShmChannel::OpenMode::Create);
+        } catch (const std::system_error &) {
+            threw = true;
+        }
+        assert(threw && "Creating an existing channel should throw.");
+    }
+
+    std::cout << "All shm channel tests passed." << std::endl;
+    return 0;
+}
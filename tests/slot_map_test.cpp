@@ -0,0 +1,109 @@
+/**
+ * @file slot_map_test.cpp
+ * @brief Unit tests for the SlotMap container.
+ *
+ * This file contains unit tests for the generational slot map to verify that:
+ * - Values are found by their keys and stored contiguously.
+ * - Erasing a value keeps the others reachable by their keys and the storage dense.
+ * - Keys to erased values stay stale, also after their slot is reused.
+ * - Random insert/erase sequences agree with a reference model.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the SlotMap implementation.
+ */
+
+#include "observer/slot_map.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace observer;
+
+int main() {
+    // Test 1: Insertion and lookup.
+    {
+        SlotMap<std::string> map;
+        const SlotKey a = map.insert("a");
+        const SlotKey b = map.insert("b");
+        const SlotKey c = map.insert("c");
+        assert(map.size() == 3);
+        assert(*map.find(a) == "a" && *map.find(b) == "b" && *map.find(c) == "c");
+        assert(&map[1] == &map[0] + 1 && "Values should be stored contiguously.");
+        assert(!map.contains(SlotKey{}) && "A default key refers to nothing.");
+        assert(map.keyAt(2) == c);
+    }
+
+    // Test 2: Erasure moves the last value into the hole.
+    {
+        SlotMap<int> map;
+        std::vector<SlotKey> keys;
+        for (int i = 0; i < 5; ++i) {
+            keys.push_back(map.insert(i));
+        }
+        assert(map.erase(keys[1]));
+        assert(!map.erase(keys[1]) && "Erasing twice should fail.");
+        assert(map.size() == 4 && map[1] == 4 && "The last value should fill the hole.");
+        for (int i : {0, 2, 3, 4}) {
+            assert(*map.find(keys[i]) == i && "Other keys should still find their values.");
+        }
+        assert(map.keyAt(1) == keys[4]);
+    }
+
+    // Test 3: Stale keys after slot reuse.
+    {
+        SlotMap<int> map;
+        const SlotKey first = map.insert(1);
+        map.erase(first);
+        const SlotKey second = map.insert(2);
+        assert(second.index == first.index && "The free slot should be reused.");
+        assert(second.generation != first.generation);
+        assert(!map.contains(first) && map.find(first) == nullptr && "A stale key must not see the new value.");
+        assert(*map.find(second) == 2);
+        map.clear();
+        assert(map.empty() && !map.contains(second));
+    }
+
+    // Test 4: Random operations against a reference model.
+    {
+        SlotMap<int> map;
+        std::map<int, SlotKey> model;
+        std::vector<SlotKey> erased;
+        std::mt19937 random(42);
+        int next = 0;
+        for (int step = 0; step < 20000; ++step) {
+            if (model.empty() || random() % 3 != 0) {
+                model[next] = map.insert(next);
+                ++next;
+            } else {
+                auto victim = model.begin();
+                std::advance(victim, static_cast<long>(random() % model.size()));
+                assert(map.erase(victim->second));
+                erased.push_back(victim->second);
+                model.erase(victim);
+            }
+        }
+        assert(map.size() == model.size());
+        for (const auto &[value, key] : model) {
+            assert(map.find(key) && *map.find(key) == value);
+        }
+        for (SlotKey key : erased) {
+            assert(!map.contains(key));
+        }
+        std::size_t sum = 0;
+        for (int value : map) {
+            sum += static_cast<std::size_t>(value);
+        }
+        std::size_t expected = 0;
+        for (const auto &entry : model) {
+            expected += static_cast<std::size_t>(entry.first);
+        }
+        assert(sum == expected && "Iteration should visit every value once.");
+    }
+
+    std::cout << "All slot map tests passed." << std::endl;
+    return 0;
+}
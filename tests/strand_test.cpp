@@ -0,0 +1,191 @@
+/**
+ * @file strand_test.cpp
+ * @brief Unit tests for the Strand class.
+ *
+ * This file contains unit tests for strands on top of the Executor to verify that:
+ * - Events posted to one strand never overlap and run in FIFO order, also when several
+ *   threads post to it and handlers post follow-up events to their own strand.
+ * - Events of different strands run in parallel on different workers.
+ * - runningInThisThread() is true only inside the strand's own handlers.
+ * - Hundreds of thousands of short-lived strands can be created, used and destroyed, and
+ *   their pending events still run after the last handle is gone.
+ * - Posting fails once the executor has been shut down, and an event whose post() returned
+ *   true runs even when the post races with shutdown().
+ * - A strand whose run is dropped by ShutdownMode::Discard goes idle: later posts fail and its
+ *   pending events are released.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the Strand implementation.
+ */
+
+#include "event_queue/strand.hpp"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace event_queue;
+
+int main() {
+    // Test 1: Serial FIFO execution per strand, with concurrent posters.
+    {
+        constexpr int kStrands = 8;
+        constexpr int kPosters = 2;
+        constexpr int kEventsPerPoster = 2000;
+        Executor executor(4);
+        std::vector<Strand> strands;
+        std::vector<std::vector<int>> seen(kStrands);
+        std::vector<std::atomic<bool>> active(kStrands);
+        std::atomic<bool> overlapped{false};
+        for (int s = 0; s < kStrands; ++s) {
+            strands.emplace_back(executor);
+        }
+
+        std::vector<std::thread> posters;
+        for (int p = 0; p < kPosters; ++p) {
+            posters.emplace_back([&, p]() {
+                for (int i = 0; i < kEventsPerPoster; ++i) {
+                    for (int s = 0; s < kStrands; ++s) {
+                        strands[s].post([&, s, value = p * kEventsPerPoster + i]() {
+                            if (active[s].exchange(true)) {
+                                overlapped = true;
+                            }
+                            seen[s].push_back(value); // Safe without a lock: the strand is serial.
+                            active[s] = false;
+                        });
+                    }
+                }
+            });
+        }
+        for (auto &poster : posters) {
+            poster.join();
+        }
+        executor.shutdown();
+
+        assert(!overlapped && "Events of one strand must never run concurrently.");
+        for (int s = 0; s < kStrands; ++s) {
+            assert(seen[s].size() == kPosters * kEventsPerPoster && "Every event should run exactly once.");
+            // Per poster, the values must appear in increasing order.
+            std::vector<int> last(kPosters, -1);
+            for (int value : seen[s]) {
+                const int poster = value / kEventsPerPoster;
+                assert(value > last[poster] && "Events from one poster should run in FIFO order.");
+                last[poster] = value;
+            }
+        }
+    }
+
+    // Test 2: Different strands run in parallel; handlers may post to their own strand.
+    {
+        constexpr int kStrands = 4;
+        Executor executor(kStrands);
+        std::latch allRunning(kStrands);
+        std::atomic<int> followUps{0};
+        std::vector<Strand> strands;
+        for (int s = 0; s < kStrands; ++s) {
+            strands.emplace_back(executor);
+        }
+        for (int s = 0; s < kStrands; ++s) {
+            strands[s].post([&, s]() {
+                assert(strands[s].runningInThisThread() && "A handler runs inside its strand.");
+                assert(!strands[(s + 1) % kStrands].runningInThisThread());
+                allRunning.arrive_and_wait(); // Only completes if all strands run at once.
+                strands[s].post([&followUps]() { followUps.fetch_add(1); });
+            });
+        }
+        executor.shutdown();
+        assert(followUps.load() == kStrands && "Follow-up events should run before shutdown returns.");
+        assert(!strands[0].runningInThisThread() && "The test thread is not inside any strand.");
+    }
+
+    // Test 3: Many short-lived strands.
+    {
+        constexpr int kStrands = 200000;
+        Executor executor(2);
+        std::atomic<int> ran{0};
+        for (int s = 0; s < kStrands; ++s) {
+            Strand strand(executor);
+            strand.post([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+            strand.post([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+        } // The handle is gone, but its events still run.
+        executor.shutdown();
+        assert(ran.load() == 2 * kStrands && "Events of destroyed strand handles should still run.");
+    }
+
+    // Test 4: Posting after shutdown fails.
+    {
+        Executor executor(1);
+        Strand strand(executor);
+        executor.shutdown();
+        bool ran = false;
+        assert(!strand.post([&ran]() { ran = true; }) && "post() should fail after shutdown().");
+        assert(!ran);
+        assert(&strand.executor() == &executor);
+    }
+
+    // Test 5: Every accepted event runs, also when posts race with shutdown().
+    {
+        constexpr int kRounds = 200;
+        constexpr int kPosters = 4;
+        for (int round = 0; round < kRounds; ++round) {
+            Executor executor(2);
+            Strand strand(executor);
+            std::atomic<int> accepted{0};
+            std::atomic<int> ran{0};
+            std::latch start(kPosters + 1);
+            std::vector<std::thread> posters;
+            for (int p = 0; p < kPosters; ++p) {
+                posters.emplace_back([&]() {
+                    start.arrive_and_wait();
+                    for (int i = 0; i < 50; ++i) {
+                        if (strand.post([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); })) {
+                            accepted.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                });
+            }
+            start.arrive_and_wait();
+            executor.shutdown();
+            for (auto &poster : posters) {
+                poster.join();
+            }
+            assert(ran.load() == accepted.load() && "An accepted event must not be dropped.");
+        }
+    }
+
+    // Test 6: A run dropped by ShutdownMode::Discard leaves the strand idle, so later posts fail.
+    {
+        Executor executor(1);
+        Strand strand(executor);
+        std::atomic<bool> release{false};
+        std::atomic<bool> started{false};
+        std::atomic<int> ran{0};
+        auto token = std::make_shared<int>(0);
+        strand.post([&]() {
+            started = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        });
+        while (!started) {
+            std::this_thread::yield();
+        }
+        // Queued behind the running event: the strand resubmits itself to run it.
+        const bool queued = strand.post([&ran, token]() { ran.fetch_add(1); });
+        assert(queued && "post() should succeed while the executor runs.");
+        std::thread stopper([&executor]() { executor.shutdown(Executor::ShutdownMode::Discard); });
+        while (executor.submit([]() {})) {
+            std::this_thread::yield();
+        }
+        release = true;
+        stopper.join();
+        assert(!strand.post([&ran, token]() { ran.fetch_add(1); }) && "post() should fail once the run was dropped.");
+        assert(ran.load() == 0 && "Discarded events should not run.");
+        assert(token.use_count() == 1 && "The strand should not keep discarded events.");
+    }
+
+    std::cout << "All strand tests passed." << std::endl;
+    return 0;
+}
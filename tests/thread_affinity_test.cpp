@@ -0,0 +1,135 @@
+/**
+ * @file thread_affinity_test.cpp
+ * @brief Unit tests for the CPU topology, pinning and NUMA placement helpers.
+ *
+ * This file contains unit tests for thread affinity and NUMA placement to verify that:
+ * - The machine topology lists at least one CPU, and explicit topologies are summarized and
+ *   queried per node.
+ * - A thread pinned to a CPU runs on it (Linux).
+ * - Executor workers configured with CPUs report their placement and run their events there.
+ * - EventQueues bound to a NUMA node, and NumaMemoryResource, work with every backend.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the placement helpers.
+ */
+
+#include "event_queue/executor.hpp"
+#include "event_queue/thread_affinity.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace event_queue;
+
+int main() {
+    const CpuTopology &topology = CpuTopology::system();
+
+    // Test 1: Topology discovery and queries.
+    {
+        assert(!topology.cpus().empty() && "At least one CPU should be online.");
+        assert(topology.nodeCount() >= 1);
+        assert(topology.nodeOf(topology.cpus().front().cpu) >= 0);
+        assert(topology.nodeOf(1u << 30) == -1 && "Unknown CPUs have no node.");
+        std::cout << "Topology: " << topology.describe() << std::endl;
+
+        const CpuTopology twoSockets({{3, 1, 1}, {0, 0, 0}, {2, 1, 1}, {1, 0, 0}});
+        assert(twoSockets.describe() == "2 NUMA nodes, 2 packages, 4 CPUs (node 0: 0-1; node 1: 2-3)");
+        assert((twoSockets.cpusOnNode(1) == std::vector<unsigned>{2, 3}));
+        assert(twoSockets.nodeOf(3) == 1);
+    }
+
+    // The CPU the test runs on is certainly one it may be pinned to.
+    const int here = currentCpu();
+    const unsigned target = here >= 0 ? static_cast<unsigned>(here) : topology.cpus().front().cpu;
+
+#if defined(__linux__)
+    // Test 2: Pinning a thread.
+    {
+        std::thread thread([target]() {
+            assert(pinCurrentThread(target) && "Pinning to an allowed CPU should succeed.");
+            for (int i = 0; i < 100; ++i) {
+                assert(currentCpu() == static_cast<int>(target) && "A pinned thread should stay on its CPU.");
+                std::this_thread::yield();
+            }
+        });
+        thread.join();
+    }
+
+    // Test 3: Pinned executor workers.
+    {
+        Executor::Options options;
+        options.workerCount = 2;
+        options.cpus = {target};
+        Executor executor(options);
+        for (const Executor::WorkerPlacement &placement : executor.placement()) {
+            assert(placement.cpu == static_cast<int>(target) && "Every worker should report its CPU.");
+            assert(placement.node == topology.nodeOf(target));
+        }
+        std::atomic<int> elsewhere{0};
+        for (int i = 0; i < 200; ++i) {
+            executor.submit([&elsewhere, target]() {
+                if (currentCpu() != static_cast<int>(target)) {
+                    elsewhere.fetch_add(1);
+                }
+            });
+        }
+        executor.shutdown();
+        assert(elsewhere.load() == 0 && "Pinned workers should run events on their CPU.");
+    }
+#endif
+
+    // Test 4: Unpinned executors report no placement.
+    {
+        Executor executor(2);
+        for (const Executor::WorkerPlacement &placement : executor.placement()) {
+            assert(placement.cpu == -1 && placement.node == -1);
+        }
+    }
+
+    // Test 5: Queues and memory bound to a NUMA node.
+    {
+        const int node = topology.nodeOf(target);
+        for (EventQueue::Backend backend :
+             {EventQueue::Backend::Mutex, EventQueue::Backend::LockFreeRing, EventQueue::Backend::ShardedSpsc}) {
+            EventQueue::Options options;
+            options.backend = backend;
+            options.capacity = backend == EventQueue::Backend::Mutex ? 4096 : 0;
+            options.numaNode = node;
+            EventQueue queue(options);
+            std::size_t payloadBytes = 0;
+            int ran = 0;
+            const std::vector<std::byte> payload(300, std::byte{7});
+            for (int i = 0; i < 100; ++i) {
+                queue.pushEvent([&ran]() { ++ran; });
+                queue.pushPayloadEvent(payload, [&payloadBytes](std::span<const std::byte> bytes) {
+                    payloadBytes += bytes.size();
+                });
+            }
+            if (backend == EventQueue::Backend::ShardedSpsc) {
+                EventQueue::Producer producer = queue.registerProducer();
+                producer.push([&ran]() { ++ran; });
+            }
+            queue.processEvents();
+            assert(ran == (backend == EventQueue::Backend::ShardedSpsc ? 101 : 100));
+            assert(payloadBytes == 100 * payload.size() && "Payloads in bound arena chunks should be intact.");
+        }
+
+        NumaMemoryResource resource(node);
+        assert(resource.node() == node);
+        void *block = resource.allocate(1 << 20, 4096);
+        static_cast<unsigned char *>(block)[0] = 1;
+        resource.deallocate(block, 1 << 20, 4096);
+
+        std::byte small[16];
+        assert(!bindToNumaNode(small, sizeof(small), -1) && "A negative node means no binding.");
+#if defined(__linux__)
+        assert(bindToNumaNode(small, sizeof(small), 0) && "A range without a whole page needs no binding.");
+#endif
+    }
+
+    std::cout << "All thread affinity tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * @file topic_broker_test.cpp
+ * @brief Unit tests for the BasicTopicBroker class.
+ *
+ * This file contains unit tests for the topic broker to verify that:
+ * - Literal, "*" and "#" patterns match the topics they should, and only those.
+ * - Ending a subscription stops its notifications, also from inside onNotify(), and new
+ *   subscriptions are seen by later publishes even when the topic's matches are cached.
+ * - The match cache is bounded, and a subscribe or unsubscribe drops only the cached topics its
+ *   pattern matches.
+ * - Patterns that misuse wildcards, and topics containing wildcards, are refused, and a refused
+ *   pattern leaves nothing behind in the trie.
+ * - Random subscriptions and topics agree with a reference matcher, with and without cache.
+ *
+ * If any assertion fails, the test will abort, indicating an issue with the TopicBroker implementation.
+ */
+
+#include "observer/topic_broker.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace observer;
+
+namespace {
+
+/**
+ * @brief Records the messages it receives.
+ */
+class RecordingObserver : public IObserver {
+public:
+    void onNotify(const std::string &message) override { messages.push_back(message); }
+
+    std::vector<std::string> messages; ///< Received messages, in order.
+};
+
+/**
+ * @brief Ends its own subscription and subscribes a partner when notified.
+ */
+class HandOffObserver : public IObserver {
+public:
+    HandOffObserver(TopicBroker &broker, IObserver &partner) : broker_(broker), partner_(partner) {}
+
+    void onNotify(const std::string &) override {
+        ++calls;
+        subscription.unsubscribe();
+        partnerSubscription = broker_.subscribe("a.b", &partner_);
+    }
+
+    Subscription subscription;        ///< This observer's subscription.
+    Subscription partnerSubscription; ///< The partner's subscription, made during a publish.
+    int calls = 0;                    ///< Number of notifications received.
+
+private:
+    TopicBroker &broker_;
+    IObserver &partner_;
+};
+
+std::vector<std::string_view> splitLevels(std::string_view topic) {
+    std::vector<std::string_view> levels;
+    detail::forEachLevel(topic, [&levels](std::string_view level, bool) { levels.push_back(level); });
+    return levels;
+}
+
+/**
+ * @brief Straightforward recursive matcher used as the reference.
+ */
+bool referenceMatch(const std::vector<std::string_view> &pattern, std::size_t p,
+                    const std::vector<std::string_view> &topic, std::size_t t) {
+    if (p == pattern.size()) {
+        return t == topic.size();
+    }
+    if (pattern[p] == "#") {
+        return true;
+    }
+    if (t == topic.size()) {
+        return false;
+    }
+    return (pattern[p] == "*" || pattern[p] == topic[t]) && referenceMatch(pattern, p + 1, topic, t + 1);
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Wildcard semantics.
+    {
+        TopicBroker broker;
+        RecordingObserver exact, star, hash, root, all;
+        Subscription s1 = broker.subscribe("orders.eu.fr", &exact);
+        Subscription s2 = broker.subscribe("orders.*.fr", &star);
+        Subscription s3 = broker.subscribe("orders.#", &hash);
+        Subscription s4 = broker.subscribe("orders", &root);
+        Subscription s5 = broker.subscribe("#", &all);
+        assert(broker.subscriptionCount() == 5);
+
+        assert(broker.publish("orders.eu.fr", "1") == 4);
+        assert(broker.publish("orders.us.fr", "2") == 3);
+        assert(broker.publish("orders", "3") == 3 && "'#' should also match zero levels.");
+        assert(broker.publish("orders.eu", "4") == 2 && "'*' should match exactly one level.");
+        assert(broker.publish("trades.eu.fr", "5") == 1);
+
+        assert((exact.messages == std::vector<std::string>{"1"}));
+        assert((star.messages == std::vector<std::string>{"1", "2"}));
+        assert((hash.messages == std::vector<std::string>{"1", "2", "3", "4"}));
+        assert((root.messages == std::vector<std::string>{"3"}));
+        assert(all.messages.size() == 5);
+    }
+
+    // Test 2: Unsubscribing, and subscribing to cached topics.
+    {
+        TopicBroker broker;
+        RecordingObserver first, second, partner;
+        Subscription s1 = broker.subscribe("a.*", &first);
+        assert(broker.publish("a.b", "cached") == 1);
+        assert(broker.cachedTopics() == 1);
+        {
+            Subscription s2 = broker.subscribe("a.b", &second);
+            assert(broker.publish("a.b", "new") == 2 && "A new subscription should invalidate the cache.");
+        }
+        assert(broker.publish("a.b", "gone") == 1 && "An ended subscription should not be notified.");
+        assert((second.messages == std::vector<std::string>{"new"}));
+
+        HandOffObserver handOff(broker, partner);
+        handOff.subscription = broker.subscribe("a.#", &handOff);
+        s1.unsubscribe();
+        assert(broker.publish("a.b", "hand-off") == 1);
+        assert(broker.publish("a.b", "after") == 1);
+        assert(handOff.calls == 1 && "An observer that unsubscribed itself should not be notified again.");
+        assert((partner.messages == std::vector<std::string>{"after"}) &&
+               "A subscription made during a publish is first notified by the next one.");
+        assert(broker.subscriptionCount() == 1);
+    }
+
+    // Test 3: The cache is bounded.
+    {
+        TopicBroker::Options options;
+        options.cacheCapacity = 8;
+        TopicBroker broker(options);
+        RecordingObserver observer;
+        Subscription subscription = broker.subscribe("t.*", &observer);
+        for (int i = 0; i < 100; ++i) {
+            assert(broker.publish("t." + std::to_string(i % 20), "x") == 1);
+        }
+        assert(broker.cachedTopics() == 8);
+        assert(observer.messages.size() == 100);
+    }
+
+    // Test 4: Invalid patterns and topics.
+    {
+        TopicBroker broker;
+        RecordingObserver observer;
+        for (const char *pattern : {"a.#.b", "a.b*", "#x"}) {
+            bool threw = false;
+            try {
+                Subscription subscription = broker.subscribe(pattern, &observer);
+            } catch (const std::invalid_argument &) {
+                threw = true;
+            }
+            assert(threw && "Misused wildcards should be refused.");
+        }
+        bool threw = false;
+        try {
+            broker.publish("a.*", "x");
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw && "Publishing to a wildcard topic should be refused.");
+        assert(broker.subscriptionCount() == 0);
+
+        detail::TopicRegistry<std::string> registry(0);
+        const SlotKey key = registry.subscribe("a.b", &observer);
+        const std::size_t nodes = registry.nodeCount();
+        for (const char *pattern : {"a.b.#.c", "a.b*", "x.y.#.z", "a.*.b#"}) {
+            try {
+                registry.subscribe(pattern, &observer);
+            } catch (const std::invalid_argument &) {
+            }
+        }
+        assert(registry.nodeCount() == nodes && "A refused pattern should not leave trie nodes behind.");
+        registry.remove(key);
+        assert(registry.nodeCount() == 0);
+    }
+
+    // Test 5: Random patterns and topics against the reference matcher.
+    for (std::size_t capacity : {std::size_t{0}, std::size_t{16}}) {
+        std::mt19937 random(7);
+        const std::vector<std::string> words{"a", "b", "c"};
+        const auto randomTopic = [&](bool wildcards) {
+            std::string topic;
+            const int depth = 1 + static_cast<int>(random() % 4);
+            for (int level = 0; level < depth; ++level) {
+                std::string word = words[random() % words.size()];
+                if (wildcards && random() % 4 == 0) {
+                    word = "*";
+                }
+                if (wildcards && level == depth - 1 && random() % 5 == 0) {
+                    word = "#";
+                }
+                topic += (level ? "." : "") + word;
+            }
+            return topic;
+        };
+
+        TopicBroker::Options options;
+        options.cacheCapacity = capacity;
+        TopicBroker broker(options);
+        std::vector<std::string> patterns;
+        std::vector<std::unique_ptr<RecordingObserver>> observers;
+        std::vector<Subscription> subscriptions;
+        for (int i = 0; i < 60; ++i) {
+            patterns.push_back(randomTopic(true));
+            observers.push_back(std::make_unique<RecordingObserver>());
+            subscriptions.push_back(broker.subscribe(patterns.back(), observers.back().get()));
+        }
+        for (int round = 0; round < 500; ++round) {
+            if (round % 10 == 9) {
+                // Churn: replace one subscription.
+                const std::size_t victim = random() % patterns.size();
+                patterns[victim] = randomTopic(true);
+                subscriptions[victim] = broker.subscribe(patterns[victim], observers[victim].get());
+            }
+            const std::string topic = randomTopic(false);
+            const std::vector<std::string_view> topicLevels = splitLevels(topic);
+            std::size_t expected = 0;
+            for (const std::string &pattern : patterns) {
+                expected += referenceMatch(splitLevels(pattern), 0, topicLevels, 0) ? 1 : 0;
+            }
+            assert(broker.publish(topic, topic) == expected && "The trie should agree with the reference matcher.");
+        }
+    }
+
+    // Test 6: Subscriptions invalidate only the cached topics they match.
+    {
+        TopicBroker broker;
+        RecordingObserver observer;
+        Subscription base = broker.subscribe("#", &observer);
+        for (const char *topic : {"a.b", "a.c", "a.b.c", "d.e"}) {
+            broker.publish(topic, "x");
+        }
+        assert(broker.cachedTopics() == 4);
+        {
+            Subscription exact = broker.subscribe("a.b", &observer);
+            assert(broker.cachedTopics() == 3 && "An exact pattern should only drop its own topic.");
+            assert(broker.publish("a.b", "x") == 2);
+        }
+        assert(broker.cachedTopics() == 3 && "Unsubscribing should only drop the topics the pattern matches.");
+        assert(broker.publish("a.b", "x") == 1);
+        Subscription star = broker.subscribe("a.*", &observer);
+        assert(broker.cachedTopics() == 2 && "'a.*' should drop 'a.b' and 'a.c' only.");
+        Subscription hash = broker.subscribe("a.#", &observer);
+        assert(broker.cachedTopics() == 1 && "'a.#' should drop every cached topic under 'a'.");
+        assert(broker.publish("a.b.c", "x") == 2);
+        assert(broker.publish("d.e", "x") == 1);
+        Subscription unrelated = broker.subscribe("z.*", &observer);
+        assert(broker.cachedTopics() == 2 && "A pattern matching no cached topic should drop nothing.");
+    }
+
+    std::cout << "All topic broker tests passed." << std::endl;
+    return 0;
+}